@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui sql printsupport
+QT       += core gui sql printsupport concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -23,7 +23,25 @@ SOURCES += main.cpp\
     configmanager.cpp \
     csvwriter.cpp \
     tableprinter.cpp \
-    printlayout.cpp
+    printlayout.cpp \
+    lazyrowsizer.cpp \
+    columnwidthestimator.cpp \
+    startupprofile.cpp \
+    dbmigrator.cpp \
+    entrylookup.cpp \
+    compacttable.cpp \
+    compacttablemodel.cpp \
+    lookupmodel.cpp \
+    transferprefetcher.cpp \
+    databasepersister.cpp \
+    querycache.cpp \
+    changeset.cpp \
+    binarydump.cpp \
+    searchfilter.cpp \
+    searchrow.cpp \
+    transfergraph.cpp \
+    trigramindex.cpp \
+    fuzzymatcher.cpp
 
 HEADERS  += mainwindow.h \
     database.h \
@@ -35,6 +53,24 @@ HEADERS  += mainwindow.h \
     csvwriter.h \
     tableprinter.h \
     printlayout.h \
+    lazyrowsizer.h \
+    columnwidthestimator.h \
+    startupprofile.h \
+    dbmigrator.h \
+    entrylookup.h \
+    compacttable.h \
+    compacttablemodel.h \
+    lookupmodel.h \
+    transferprefetcher.h \
+    databasepersister.h \
+    querycache.h \
+    changeset.h \
+    binarydump.h \
+    searchfilter.h \
+    searchrow.h \
+    transfergraph.h \
+    trigramindex.h \
+    fuzzymatcher.h \
     version.h
 
 FORMS    += mainwindow.ui \
@@ -60,3 +96,12 @@ win32: RC_ICONS = images/akdb.ico
 # Usage of system wide installed and accessible QuaZIP
  LIBS += -lquazip5
  INCLUDEPATH += /usr/include/quazip5
+
+# The native SQLite API (online backup of the in-memory mode, busy handler statistics)
+# may only be used if the Qt SQLite driver is built against the system library (Qt configured with -system-sqlite).
+# Enable it with "qmake CONFIG+=system_sqlite", otherwise everything goes through the Qt driver.
+# This is the supported build for the in-memory mode: the fallback through the Qt driver rewrites the whole file on every save.
+system_sqlite {
+    DEFINES += NATIVE_SQLITE
+    LIBS += -lsqlite3
+}
@@ -0,0 +1,542 @@
+/*
+ * binarydump.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "binarydump.h"
+#include "database.h"
+
+/*!
+ * \class BinaryDump
+ *
+ * \brief Writes all tables of a database into a compact binary file and loads them again
+ *
+ * The file starts with the identification \c ADBDUMP and the version of the format.
+ * It is followed by blocks of at most 64 KiB, each compressed by zlib and preceded by its compressed size.
+ * The uncompressed data holds the schema version, the SQL of all tables, indexes, triggers and views
+ * and then the entries of each table.
+ *
+ * Integers are stored as variable length integers, so small numbers like IDs and ECTS take one or two bytes.
+ * Each distinct text is written only once; any further occurrence refers to it by its number in the shared string table.
+ *
+ * When loading, the tables are created and filled within a single transaction.
+ * The indexes, triggers and views are only created after all entries are loaded, so no trigger fires
+ * and each index is built at once instead of being updated for every entry.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the BinaryDump for the database connection \a database
+ */
+BinaryDump::BinaryDump(QSqlDatabase database) : db(database), entries(0), blockPos(0)
+{}
+
+/*!
+ * \brief Writes the schema and all entries of the database to the file \a fileName
+ *
+ * An existing file \a fileName is overwritten. Returns \c true on success, otherwise \c false and the file is removed.
+ */
+bool BinaryDump::write(const QString &fileName)
+{
+    entries = 0;
+    error.clear();
+    pending.clear();
+    stringIds.clear();
+
+    file.setFileName(fileName);
+    if(!file.open(QIODevice::WriteOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    file.write(dump_magic);
+    file.putChar(char(dump_format));
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare("PRAGMA user_version");
+    bool success = exec(&query, "writeDump") && query.next();
+    if(success) {
+        writeVarint(query.value(0).toULongLong());
+    }
+    query.finish();
+
+    // the tables first, then the indexes, views and triggers
+    QVector<SchemaEntry> schema;
+    query.prepare("SELECT type, name, sql FROM sqlite_master WHERE sql IS NOT NULL AND name NOT LIKE 'sqlite!_%' ESCAPE '!' "
+                  "ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'index' THEN 1 WHEN 'view' THEN 2 ELSE 3 END, rowid");
+    success = success && exec(&query, "writeDump");
+    while(success && query.next()) {
+        SchemaEntry entry;
+        entry.type = query.value(0).toString();
+        entry.name = query.value(1).toString();
+        entry.sql = query.value(2).toString();
+        schema << entry;
+    }
+    query.finish();
+    writeVarint(schema.size());
+    for(int i = 0; i < schema.size(); i++) {
+        writeValue(schema.at(i).type);
+        writeValue(schema.at(i).name);
+        writeValue(schema.at(i).sql);
+    }
+
+    // the entries of each table, each preceded by a marker, and a marker for the end of the table
+    for(int i = 0; i < schema.size() && success; i++) {
+        if(schema.at(i).type != "table") continue;
+
+        query.prepare(QString("SELECT * FROM \"%1\"").arg(schema.at(i).name));
+        success = exec(&query, "writeDump");
+        if(!success) break;
+
+        QSqlRecord record = query.record();
+        writeValue(schema.at(i).name);
+        writeVarint(record.count());
+        for(int c = 0; c < record.count(); c++) {
+            writeValue(record.fieldName(c));
+        }
+        while(success && query.next()) {
+            writeVarint(1);
+            for(int c = 0; c < record.count(); c++) {
+                writeValue(query.value(c));
+            }
+            entries++;
+            success = flushBlock(false);
+        }
+        writeVarint(0);
+        query.finish();
+    }
+    writeValue(QVariant());
+
+    success = success && flushBlock(true);
+    file.close();
+    if(!success) {
+        file.remove();
+    }
+    return success;
+}
+
+/*!
+ * \brief Loads the schema and all entries of the file \a fileName into the database
+ *
+ * The database needs to be empty. The schema version of the dump is set as well,
+ * so an older dump is migrated when the database is opened.
+ *
+ * Returns \c true on success, otherwise \c false and the database is left unchanged.
+ */
+bool BinaryDump::read(const QString &fileName)
+{
+    entries = 0;
+    error.clear();
+    block.clear();
+    blockPos = 0;
+    strings.clear();
+
+    file.setFileName(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    QByteArray header = file.read(8);
+    if(header.size() != 8 || !header.startsWith(dump_magic) || quint8(header.at(7)) != dump_format) {
+        error = QObject::tr("The file '%1' is no binary dump of this version of AnerkennungsDB.").arg(fileName);
+        file.close();
+        return false;
+    }
+
+    quint64 version = 0;
+    quint64 count = 0;
+    QVector<SchemaEntry> schema;
+    bool success = readVarint(version) && readVarint(count);
+    for(quint64 i = 0; success && i < count; i++) {
+        SchemaEntry entry;
+        success = readString(entry.type) && readString(entry.name) && readString(entry.sql);
+        schema << entry;
+    }
+    if(!success || !db.transaction()) {
+        if(error.isEmpty()) {
+            error = db.lastError().text();
+        }
+        file.close();
+        return false;
+    }
+
+    // create the tables
+    for(int i = 0; i < schema.size() && success; i++) {
+        if(schema.at(i).type == "table") {
+            QSqlQuery query(db);
+            query.prepare(schema.at(i).sql);
+            success = exec(&query, "readDump");
+        }
+    }
+
+    // load the entries table by table
+    while(success) {
+        QVariant name;
+        quint64 columns = 0;
+        success = readValue(name);
+        if(!success || name.isNull()) break;
+        success = readVarint(columns);
+
+        QStringList names;
+        for(quint64 c = 0; c < columns && success; c++) {
+            QString column;
+            success = readString(column);
+            names << QString("\"%1\"").arg(column);
+        }
+        if(!success || names.isEmpty()) break;
+
+        QSqlQuery insert(db);
+        insert.prepare(QString("INSERT INTO \"%1\" (%2) VALUES (%3)").arg(name.toString()).arg(names.join(","))
+                       .arg(QString("?,").repeated(names.size() - 1).append("?")));
+        quint64 marker = 0;
+        while(success && (success = readVarint(marker)) && marker == 1) {
+            for(int c = 0; c < names.size() && success; c++) {
+                QVariant value;
+                success = readValue(value);
+                insert.bindValue(c, value);
+            }
+            success = success && exec(&insert, "readDump");
+            entries++;
+        }
+        if(success && marker != 0) {
+            error = QObject::tr("The dump file is damaged.");
+            success = false;
+        }
+    }
+
+    // create the indexes, triggers and views after all entries are loaded
+    for(int i = 0; i < schema.size() && success; i++) {
+        if(schema.at(i).type != "table") {
+            QSqlQuery query(db);
+            query.prepare(schema.at(i).sql);
+            success = exec(&query, "readDump");
+        }
+    }
+    if(success) {
+        QSqlQuery query(db);
+        query.prepare(QString("PRAGMA user_version = %1").arg(version));
+        success = exec(&query, "readDump");
+    }
+    file.close();
+
+    if(success && db.commit()) {
+        return true;
+    }
+    if(error.isEmpty()) {
+        error = db.lastError().text();
+    }
+    db.rollback();
+    entries = 0;
+    return false;
+}
+
+/*!
+ * \brief Returns the number of entries written or loaded by the last call
+ */
+int BinaryDump::entryCount() const
+{
+    return entries;
+}
+
+/*!
+ * \brief Returns the error of the last failed call
+ */
+QString BinaryDump::lastError() const
+{
+    return error;
+}
+
+/*!
+ * \brief Executes the already prepared \a query
+ *
+ * Returns \c true on success, otherwise \c false and the error is kept.
+ */
+bool BinaryDump::exec(QSqlQuery *query, const QString &method)
+{
+    if(!Database::exec(query, method)) {
+        error = query->lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Appends \a value to \a bytes as variable length integer
+ *
+ * Each byte holds seven bits of the value, starting with the lowest ones.
+ * The highest bit is set if further bytes follow.
+ */
+void BinaryDump::appendVarint(QByteArray &bytes, quint64 value)
+{
+    while(value >= 0x80) {
+        bytes.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    bytes.append(char(value));
+}
+
+/*!
+ * \brief Writes the single byte \a byte
+ */
+void BinaryDump::writeByte(quint8 byte)
+{
+    pending.append(char(byte));
+}
+
+/*!
+ * \brief Writes \a value as variable length integer
+ */
+void BinaryDump::writeVarint(quint64 value)
+{
+    appendVarint(pending, value);
+}
+
+/*!
+ * \brief Writes \a value preceded by its type tag
+ *
+ * Signed integers are zigzag encoded, so that small negative numbers are short as well.
+ * Texts are added to the string table on their first occurrence and referred to by their number afterwards.
+ */
+void BinaryDump::writeValue(const QVariant &value)
+{
+    if(value.isNull()) {
+        writeByte(NullTag);
+        return;
+    }
+
+    switch(value.type()) {
+    case QVariant::Bool:
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong: {
+        qint64 integer = value.toLongLong();
+        writeByte(IntegerTag);
+        writeVarint((quint64(integer) << 1) ^ quint64(integer >> 63));
+        break;
+    }
+    case QVariant::Double: {
+        double real = value.toDouble();
+        quint64 bits;
+        memcpy(&bits, &real, sizeof(bits));
+        writeByte(RealTag);
+        for(int i = 0; i < 8; i++) {
+            writeByte(quint8(bits >> (8 * i)));
+        }
+        break;
+    }
+    case QVariant::ByteArray: {
+        QByteArray blob = value.toByteArray();
+        writeByte(BlobTag);
+        writeVarint(blob.size());
+        pending.append(blob);
+        break;
+    }
+    default: {
+        QString string = value.toString();
+        QHash<QString, quint64>::const_iterator it = stringIds.constFind(string);
+        if(it != stringIds.constEnd()) {
+            writeByte(StringTag);
+            writeVarint(it.value());
+        } else {
+            QByteArray utf8 = string.toUtf8();
+            stringIds.insert(string, stringIds.size());
+            writeByte(NewStringTag);
+            writeVarint(utf8.size());
+            pending.append(utf8);
+        }
+        break;
+    }
+    }
+}
+
+/*!
+ * \brief Compresses the pending data and writes it to the file as a block
+ *
+ * Unless \a force is \c true, this is only done when the pending data reached the block size.
+ * Returns \c true on success, otherwise \c false.
+ */
+bool BinaryDump::flushBlock(bool force)
+{
+    if(pending.isEmpty() || (!force && pending.size() < dump_block_size)) {
+        return true;
+    }
+
+    QByteArray compressed = qCompress(pending);
+    pending.clear();
+    QByteArray size;
+    appendVarint(size, compressed.size());
+    if(file.write(size) != size.size() || file.write(compressed) != compressed.size()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Reads and uncompresses the next block of the file
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool BinaryDump::nextBlock()
+{
+    quint64 size = 0;
+    int shift = 0;
+    char byte = 0;
+    do {
+        if(!file.getChar(&byte)) {
+            error = QObject::tr("The dump file is incomplete.");
+            return false;
+        }
+        size |= quint64(quint8(byte) & 0x7f) << shift;
+        shift += 7;
+    } while((quint8(byte) & 0x80) && shift < 64);
+
+    QByteArray compressed = file.read(qint64(size));
+    block = qUncompress(compressed);
+    blockPos = 0;
+    if(quint64(compressed.size()) != size || block.isEmpty()) {
+        error = QObject::tr("The dump file is damaged.");
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Reads a single byte into \a byte
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool BinaryDump::readByte(quint8 &byte)
+{
+    if(blockPos >= block.size() && !nextBlock()) {
+        return false;
+    }
+    byte = quint8(block.at(blockPos++));
+    return true;
+}
+
+/*!
+ * \brief Reads a variable length integer into \a value
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool BinaryDump::readVarint(quint64 &value)
+{
+    value = 0;
+    int shift = 0;
+    quint8 byte = 0;
+    do {
+        if(!readByte(byte)) {
+            return false;
+        }
+        value |= quint64(byte & 0x7f) << shift;
+        shift += 7;
+    } while((byte & 0x80) && shift < 64);
+    return true;
+}
+
+/*!
+ * \brief Reads \a length bytes into \a bytes, which may span several blocks
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool BinaryDump::readBytes(int length, QByteArray &bytes)
+{
+    bytes.clear();
+    bytes.reserve(length);
+    while(bytes.size() < length) {
+        if(blockPos >= block.size() && !nextBlock()) {
+            return false;
+        }
+        int count = qMin(length - bytes.size(), block.size() - blockPos);
+        bytes.append(block.constData() + blockPos, count);
+        blockPos += count;
+    }
+    return true;
+}
+
+/*!
+ * \brief Reads a value with its type tag into \a value
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool BinaryDump::readValue(QVariant &value)
+{
+    quint8 tag = 0;
+    quint64 number = 0;
+    QByteArray bytes;
+    if(!readByte(tag)) {
+        return false;
+    }
+
+    switch(tag) {
+    case NullTag:
+        value = QVariant();
+        return true;
+    case IntegerTag:
+        if(!readVarint(number)) return false;
+        value = qlonglong((number >> 1) ^ (0 - (number & 1)));
+        return true;
+    case RealTag: {
+        if(!readBytes(8, bytes)) return false;
+        quint64 bits = 0;
+        for(int i = 0; i < 8; i++) {
+            bits |= quint64(quint8(bytes.at(i))) << (8 * i);
+        }
+        double real;
+        memcpy(&real, &bits, sizeof(real));
+        value = real;
+        return true;
+    }
+    case StringTag:
+        if(!readVarint(number)) return false;
+        if(number >= quint64(strings.size())) break;
+        value = strings.at(int(number));
+        return true;
+    case NewStringTag:
+        if(!readVarint(number) || !readBytes(int(number), bytes)) return false;
+        strings.append(QString::fromUtf8(bytes));
+        value = strings.last();
+        return true;
+    case BlobTag:
+        if(!readVarint(number) || !readBytes(int(number), bytes)) return false;
+        value = bytes;
+        return true;
+    }
+    error = QObject::tr("The dump file is damaged.");
+    return false;
+}
+
+/*!
+ * \brief Reads a text into \a string
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool BinaryDump::readString(QString &string)
+{
+    QVariant value;
+    if(!readValue(value)) {
+        return false;
+    }
+    string = value.toString();
+    return true;
+}
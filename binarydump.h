@@ -0,0 +1,97 @@
+/*
+ * binarydump.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BINARYDUMP_H
+#define BINARYDUMP_H
+
+#include <QtSql>
+#include <QtDebug>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+
+// Identification of binary dump files, followed by the version of the format
+#define dump_magic "ADBDUMP"
+#define dump_format 1
+// Size of the uncompressed blocks in bytes
+#define dump_block_size 65536
+
+class BinaryDump
+{
+public:
+    explicit BinaryDump(QSqlDatabase database);
+
+    bool write(const QString &fileName);
+    bool read(const QString &fileName);
+
+    int entryCount() const;
+    QString lastError() const;
+
+private:
+    // Type tags of the values
+    enum Tag {
+        NullTag = 0,
+        IntegerTag,
+        RealTag,
+        StringTag,
+        NewStringTag,
+        BlobTag
+    };
+
+    // Entry of the schema, created before or after loading the entries
+    struct SchemaEntry {
+        QString type;
+        QString name;
+        QString sql;
+    };
+
+    QSqlDatabase db;
+    QFile file;
+    int entries;
+    QString error;
+
+    // Writing: pending uncompressed data and the string table
+    QByteArray pending;
+    QHash<QString, quint64> stringIds;
+
+    // Reading: the current uncompressed block and the string table
+    QByteArray block;
+    int blockPos;
+    QVector<QString> strings;
+
+    bool exec(QSqlQuery *query, const QString &method);
+
+    static void appendVarint(QByteArray &bytes, quint64 value);
+    void writeByte(quint8 byte);
+    void writeVarint(quint64 value);
+    void writeValue(const QVariant &value);
+    bool flushBlock(bool force);
+
+    bool nextBlock();
+    bool readByte(quint8 &byte);
+    bool readVarint(quint64 &value);
+    bool readBytes(int length, QByteArray &bytes);
+    bool readValue(QVariant &value);
+    bool readString(QString &string);
+};
+
+#endif // BINARYDUMP_H
@@ -0,0 +1,440 @@
+/*
+ * changeset.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "changeset.h"
+
+/*!
+ * \class ChangeSet
+ *
+ * \brief Exchanges the changes of the entries between copies of the database
+ *
+ * The changes since a given time are read from the change log \tt Aenderungen and the deletion log \tt Geloescht
+ * and written to a changeset file,
+ * which is a small SQLite database. It holds the current state of the changed courses, modules and transfers
+ * and the deleted ones. As the IDs differ between the copies of the database, the entries are identified by their GUIDs
+ * and the transfers refer to the GUIDs of their course and module. Origins and POs are given by their names.
+ *
+ * When a changeset is applied, each entry is taken over if it has been changed there more recently
+ * than here, compared by the time of the last modification. Otherwise it is kept and listed as conflict.
+ * Deletions are only performed if the entry has not been changed here after its deletion and is not used by any transfer.
+ * The changes applied are recorded in the change log again, so they are passed on by the next export.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the ChangeSet for the database \a database
+ */
+ChangeSet::ChangeSet(Database *database) : db(database), changed(0), deleted(0)
+{}
+
+/*!
+ * \brief Writes all changes since \a since to the changeset file \a fileName
+ *
+ * \a since is given in seconds since the epoch. An existing file \a fileName is overwritten.
+ * Besides the changed entries, the courses and modules used by the changed transfers are written as well,
+ * so that the transfers can be applied to a database which does not know them yet.
+ *
+ * Returns \c true on success, otherwise \c false and the file is removed.
+ */
+bool ChangeSet::exportChanges(const QString &fileName, qint64 since)
+{
+    changed = 0;
+    deleted = 0;
+    conflictList.clear();
+    error.clear();
+
+    if(QFile::exists(fileName) && !QFile::remove(fileName)) {
+        error = QObject::tr("The file '%1' cannot be overwritten.").arg(fileName);
+        return false;
+    }
+    if(!attach(fileName)) {
+        return false;
+    }
+
+    QString changes = "SELECT GUID FROM Aenderungen WHERE Tabelle = '%1' AND Zeit >= ?";
+    QVariantList values;
+    values << since;
+    int transfers = 0, courses = 0, modules = 0;
+
+    // small pages, as the file only holds a few entries
+    QSqlDatabase sqlite = QSqlDatabase::database();
+    bool success = execute("PRAGMA Aenderungsdatei.page_size = 1024", QVariantList(), "exportChanges")
+            && sqlite.transaction();
+    if(!success) {
+        detach();
+        QFile::remove(fileName);
+        return false;
+    }
+
+    success = execute("CREATE TABLE Aenderungsdatei.Info ("
+                        "Schluessel TEXT NOT NULL PRIMARY KEY,"
+                        "Wert TEXT"
+                      ")", QVariantList(), "exportChanges")
+            && execute("INSERT INTO Aenderungsdatei.Info (Schluessel, Wert) VALUES ('Format', ?), ('Seit', ?), ('Erstellt', ?)",
+                       QVariantList() << changeset_format << since << Database::currentEpoch(), "exportChanges")
+            && execute("CREATE TABLE Aenderungsdatei.Anerkennungen ("
+                         "GUID TEXT NOT NULL PRIMARY KEY,"
+                         "KursGUID TEXT NOT NULL,"
+                         "ModulGUID TEXT NOT NULL,"
+                         "Zeit INTEGER NOT NULL,"
+                         "Erstellt INTEGER NOT NULL"
+                       ")", QVariantList(), "exportChanges")
+            && execute("INSERT INTO Aenderungsdatei.Anerkennungen SELECT A.GUID, K.GUID, M.GUID, A.Zeit, A.Erstellt "
+                       "FROM Anerkennungen A JOIN Kurse K ON K.ID = A.KID JOIN Module M ON M.ID = A.MID "
+                       "WHERE A.GUID IN (" + changes.arg("Anerkennungen") + ")", values, "exportChanges", &transfers)
+            && execute("CREATE TABLE Aenderungsdatei.Kurse ("
+                         "GUID TEXT NOT NULL PRIMARY KEY,"
+                         "Kursname TEXT NOT NULL,"
+                         "Herkunft TEXT,"
+                         "ECTS INTEGER NOT NULL,"
+                         "Zeit INTEGER NOT NULL,"
+                         "Erstellt INTEGER NOT NULL"
+                       ")", QVariantList(), "exportChanges")
+            && execute("INSERT INTO Aenderungsdatei.Kurse SELECT K.GUID, K.Kursname, H.Name, K.ECTS, K.Zeit, K.Erstellt "
+                       "FROM Kurse K LEFT JOIN Herkunft H ON H.ID = K.HID "
+                       "WHERE K.GUID IN (" + changes.arg("Kurse") + ") OR K.GUID IN (SELECT KursGUID FROM Aenderungsdatei.Anerkennungen)",
+                       values, "exportChanges", &courses)
+            && execute("CREATE TABLE Aenderungsdatei.Module ("
+                         "GUID TEXT NOT NULL PRIMARY KEY,"
+                         "Modulname TEXT NOT NULL,"
+                         "PO TEXT,"
+                         "ECTS INTEGER NOT NULL,"
+                         "Zeit INTEGER NOT NULL,"
+                         "Erstellt INTEGER NOT NULL"
+                       ")", QVariantList(), "exportChanges")
+            && execute("INSERT INTO Aenderungsdatei.Module SELECT M.GUID, M.Modulname, P.Name, M.ECTS, M.Zeit, M.Erstellt "
+                       "FROM Module M LEFT JOIN PO P ON P.ID = M.POID "
+                       "WHERE M.GUID IN (" + changes.arg("Module") + ") OR M.GUID IN (SELECT ModulGUID FROM Aenderungsdatei.Anerkennungen)",
+                       values, "exportChanges", &modules)
+            && execute("CREATE TABLE Aenderungsdatei.Geloescht ("
+                         "Tabelle TEXT NOT NULL,"
+                         "GUID TEXT NOT NULL,"
+                         "Zeit INTEGER NOT NULL,"
+                         "PRIMARY KEY (Tabelle, GUID)"
+                       ")", QVariantList(), "exportChanges")
+            && execute("INSERT INTO Aenderungsdatei.Geloescht SELECT Tabelle, GUID, MAX(Zeit) "
+                       "FROM Geloescht WHERE GUID IS NOT NULL AND Zeit >= ? GROUP BY Tabelle, GUID", values, "exportChanges", &deleted);
+
+    if(success && sqlite.commit()) {
+        changed = transfers + courses + modules;
+    } else {
+        if(error.isEmpty()) {
+            error = sqlite.lastError().text();
+        }
+        sqlite.rollback();
+        success = false;
+    }
+    detach();
+    if(!success) {
+        QFile::remove(fileName);
+    }
+    return success;
+}
+
+/*!
+ * \brief Applies the changeset file \a fileName to the database
+ *
+ * All changes are applied within a single transaction. Entries which cannot be taken over are listed in \l conflicts().
+ *
+ * Returns \c true on success, otherwise \c false and no change is applied.
+ */
+bool ChangeSet::apply(const QString &fileName)
+{
+    changed = 0;
+    deleted = 0;
+    conflictList.clear();
+    error.clear();
+
+    if(!QFile::exists(fileName)) {
+        error = QObject::tr("The file '%1' does not exist.").arg(fileName);
+        return false;
+    }
+    if(!attach(fileName)) {
+        return false;
+    }
+
+    bool valid = false;
+    {
+        QSqlQuery query;
+        query.prepare("SELECT Wert FROM Aenderungsdatei.Info WHERE Schluessel = 'Format'");
+        valid = Database::exec(&query, "applyChanges") && query.next() && query.value(0).toInt() == changeset_format;
+    }
+    if(!valid) {
+        error = QObject::tr("The file '%1' is no changeset of this version of AnerkennungsDB.").arg(fileName);
+        detach();
+        return false;
+    }
+
+    QSqlDatabase sqlite = QSqlDatabase::database();
+    bool success = sqlite.transaction();
+    if(success) {
+        success = applyEntries() && applyDeletions();
+        if(!success || !sqlite.commit()) {
+            if(error.isEmpty()) {
+                error = sqlite.lastError().text();
+            }
+            sqlite.rollback();
+            changed = 0;
+            deleted = 0;
+            success = false;
+        }
+    } else {
+        error = sqlite.lastError().text();
+    }
+    detach();
+
+    if(changed + deleted > 0) {
+        db->contentChanged();
+    }
+    return success;
+}
+
+/*!
+ * \brief Takes over the courses, modules and transfers of the changeset which are more recent than here
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool ChangeSet::applyEntries()
+{
+    int count = 0;
+
+    // names of origins and POs which are not known yet
+    bool success = execute("INSERT OR IGNORE INTO Herkunft (Name) SELECT DISTINCT Herkunft FROM Aenderungsdatei.Kurse WHERE IFNULL(Herkunft, '') <> ''",
+                           QVariantList(), "applyChanges")
+            && execute("INSERT OR IGNORE INTO PO (Name) SELECT DISTINCT PO FROM Aenderungsdatei.Module WHERE IFNULL(PO, '') <> ''",
+                       QVariantList(), "applyChanges")
+    // entries changed more recently here are kept
+            && collectConflicts("SELECT K.Kursname FROM Aenderungsdatei.Kurse C JOIN Kurse K ON K.GUID = C.GUID WHERE K.Zeit > C.Zeit",
+                                QObject::tr("Course '%1' has been changed more recently here."))
+            && collectConflicts("SELECT M.Modulname FROM Aenderungsdatei.Module C JOIN Module M ON M.GUID = C.GUID WHERE M.Zeit > C.Zeit",
+                                QObject::tr("Module '%1' has been changed more recently here."))
+            && collectConflicts("SELECT K.Kursname, M.Modulname FROM Aenderungsdatei.Anerkennungen C JOIN Anerkennungen A ON A.GUID = C.GUID "
+                                "JOIN Kurse K ON K.ID = A.KID JOIN Module M ON M.ID = A.MID WHERE A.Zeit > C.Zeit",
+                                QObject::tr("Transfer of '%1' to '%2' has been changed more recently here."));
+    if(!success) {
+        return false;
+    }
+
+    // courses and modules
+    success = execute("UPDATE Kurse SET "
+                        "Kursname = (SELECT C.Kursname FROM Aenderungsdatei.Kurse C WHERE C.GUID = Kurse.GUID),"
+                        "HID = (SELECT H.ID FROM Aenderungsdatei.Kurse C JOIN Herkunft H ON H.Name = C.Herkunft WHERE C.GUID = Kurse.GUID),"
+                        "ECTS = (SELECT C.ECTS FROM Aenderungsdatei.Kurse C WHERE C.GUID = Kurse.GUID),"
+                        "Zeit = (SELECT C.Zeit FROM Aenderungsdatei.Kurse C WHERE C.GUID = Kurse.GUID) "
+                      "WHERE GUID IN (SELECT C.GUID FROM Aenderungsdatei.Kurse C JOIN Kurse K ON K.GUID = C.GUID WHERE C.Zeit > K.Zeit)",
+                      QVariantList(), "applyChanges", &count);
+    changed += count;
+    success = success && execute("INSERT INTO Kurse (Kursname, HID, ECTS, Zeit, Erstellt, GUID) "
+                                 "SELECT C.Kursname, H.ID, C.ECTS, C.Zeit, C.Erstellt, C.GUID "
+                                 "FROM Aenderungsdatei.Kurse C LEFT JOIN Herkunft H ON H.Name = C.Herkunft "
+                                 "WHERE C.GUID NOT IN (SELECT GUID FROM Kurse WHERE GUID IS NOT NULL)",
+                                 QVariantList(), "applyChanges", &count);
+    changed += count;
+    success = success && execute("UPDATE Module SET "
+                                   "Modulname = (SELECT C.Modulname FROM Aenderungsdatei.Module C WHERE C.GUID = Module.GUID),"
+                                   "POID = (SELECT P.ID FROM Aenderungsdatei.Module C JOIN PO P ON P.Name = C.PO WHERE C.GUID = Module.GUID),"
+                                   "ECTS = (SELECT C.ECTS FROM Aenderungsdatei.Module C WHERE C.GUID = Module.GUID),"
+                                   "Zeit = (SELECT C.Zeit FROM Aenderungsdatei.Module C WHERE C.GUID = Module.GUID) "
+                                 "WHERE GUID IN (SELECT C.GUID FROM Aenderungsdatei.Module C JOIN Module M ON M.GUID = C.GUID WHERE C.Zeit > M.Zeit)",
+                                 QVariantList(), "applyChanges", &count);
+    changed += count;
+    success = success && execute("INSERT INTO Module (Modulname, POID, ECTS, Zeit, Erstellt, GUID) "
+                                 "SELECT C.Modulname, P.ID, C.ECTS, C.Zeit, C.Erstellt, C.GUID "
+                                 "FROM Aenderungsdatei.Module C LEFT JOIN PO P ON P.Name = C.PO "
+                                 "WHERE C.GUID NOT IN (SELECT GUID FROM Module WHERE GUID IS NOT NULL)",
+                                 QVariantList(), "applyChanges", &count);
+    changed += count;
+    if(!success) {
+        return false;
+    }
+
+    // transfers, whose course and module need to exist here
+    success = collectConflicts("SELECT IFNULL(CK.Kursname, C.KursGUID), IFNULL(CM.Modulname, C.ModulGUID) FROM Aenderungsdatei.Anerkennungen C "
+                               "LEFT JOIN Aenderungsdatei.Kurse CK ON CK.GUID = C.KursGUID LEFT JOIN Aenderungsdatei.Module CM ON CM.GUID = C.ModulGUID "
+                               "WHERE C.KursGUID NOT IN (SELECT GUID FROM Kurse WHERE GUID IS NOT NULL) "
+                               "OR C.ModulGUID NOT IN (SELECT GUID FROM Module WHERE GUID IS NOT NULL)",
+                               QObject::tr("Transfer of '%1' to '%2' refers to an entry which does not exist here."))
+            && execute("UPDATE Anerkennungen SET "
+                         "KID = (SELECT K.ID FROM Aenderungsdatei.Anerkennungen C JOIN Kurse K ON K.GUID = C.KursGUID WHERE C.GUID = Anerkennungen.GUID),"
+                         "MID = (SELECT M.ID FROM Aenderungsdatei.Anerkennungen C JOIN Module M ON M.GUID = C.ModulGUID WHERE C.GUID = Anerkennungen.GUID),"
+                         "Zeit = (SELECT C.Zeit FROM Aenderungsdatei.Anerkennungen C WHERE C.GUID = Anerkennungen.GUID) "
+                       "WHERE GUID IN (SELECT C.GUID FROM Aenderungsdatei.Anerkennungen C JOIN Anerkennungen A ON A.GUID = C.GUID "
+                         "JOIN Kurse K ON K.GUID = C.KursGUID JOIN Module M ON M.GUID = C.ModulGUID WHERE C.Zeit > A.Zeit)",
+                       QVariantList(), "applyChanges", &count);
+    changed += count;
+    success = success && execute("INSERT INTO Anerkennungen (MID, KID, Zeit, Erstellt, GUID) "
+                                 "SELECT M.ID, K.ID, C.Zeit, C.Erstellt, C.GUID "
+                                 "FROM Aenderungsdatei.Anerkennungen C JOIN Kurse K ON K.GUID = C.KursGUID JOIN Module M ON M.GUID = C.ModulGUID "
+                                 "WHERE C.GUID NOT IN (SELECT GUID FROM Anerkennungen WHERE GUID IS NOT NULL)",
+                                 QVariantList(), "applyChanges", &count);
+    changed += count;
+    return success;
+}
+
+/*!
+ * \brief Deletes the entries deleted in the changeset
+ *
+ * The transfers are deleted first, so that the courses and modules are not used by them anymore.
+ * Entries changed here after their deletion and courses and modules still used by transfers are kept.
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool ChangeSet::applyDeletions()
+{
+    int count = 0;
+    bool success = collectConflicts("SELECT K.Kursname, M.Modulname FROM Aenderungsdatei.Geloescht G JOIN Anerkennungen A ON A.GUID = G.GUID "
+                                    "JOIN Kurse K ON K.ID = A.KID JOIN Module M ON M.ID = A.MID "
+                                    "WHERE G.Tabelle = 'Anerkennungen' AND A.Zeit > G.Zeit",
+                                    QObject::tr("Transfer of '%1' to '%2' has been changed here after its deletion."))
+            && execute("DELETE FROM Anerkennungen WHERE GUID IN (SELECT G.GUID FROM Aenderungsdatei.Geloescht G "
+                       "WHERE G.Tabelle = 'Anerkennungen' AND G.Zeit >= Anerkennungen.Zeit)",
+                       QVariantList(), "applyChanges", &count);
+    deleted += count;
+    success = success && collectConflicts("SELECT K.Kursname FROM Aenderungsdatei.Geloescht G JOIN Kurse K ON K.GUID = G.GUID "
+                                          "WHERE G.Tabelle = 'Kurse' AND (K.Zeit > G.Zeit OR K.ID IN (SELECT KID FROM Anerkennungen))",
+                                          QObject::tr("Course '%1' has been changed here after its deletion or is still used by a transfer."))
+            && execute("DELETE FROM Kurse WHERE GUID IN (SELECT G.GUID FROM Aenderungsdatei.Geloescht G "
+                       "WHERE G.Tabelle = 'Kurse' AND G.Zeit >= Kurse.Zeit) "
+                       "AND ID NOT IN (SELECT KID FROM Anerkennungen WHERE KID IS NOT NULL)",
+                       QVariantList(), "applyChanges", &count);
+    deleted += count;
+    success = success && collectConflicts("SELECT M.Modulname FROM Aenderungsdatei.Geloescht G JOIN Module M ON M.GUID = G.GUID "
+                                          "WHERE G.Tabelle = 'Module' AND (M.Zeit > G.Zeit OR M.ID IN (SELECT MID FROM Anerkennungen))",
+                                          QObject::tr("Module '%1' has been changed here after its deletion or is still used by a transfer."))
+            && execute("DELETE FROM Module WHERE GUID IN (SELECT G.GUID FROM Aenderungsdatei.Geloescht G "
+                       "WHERE G.Tabelle = 'Module' AND G.Zeit >= Module.Zeit) "
+                       "AND ID NOT IN (SELECT MID FROM Anerkennungen WHERE MID IS NOT NULL)",
+                       QVariantList(), "applyChanges", &count);
+    deleted += count;
+    return success;
+}
+
+/*!
+ * \brief Returns the number of entries written or taken over by the last export or application
+ */
+int ChangeSet::changedEntries() const
+{
+    return changed;
+}
+
+/*!
+ * \brief Returns the number of deletions written or performed by the last export or application
+ */
+int ChangeSet::deletedEntries() const
+{
+    return deleted;
+}
+
+/*!
+ * \brief Returns the descriptions of the entries which were not taken over by the last application
+ */
+QStringList ChangeSet::conflicts() const
+{
+    return conflictList;
+}
+
+/*!
+ * \brief Returns the error of the last failed export or application
+ */
+QString ChangeSet::lastError() const
+{
+    return error;
+}
+
+/*!
+ * \brief Attaches the changeset file \a fileName to the database connection as \tt Aenderungsdatei
+ *
+ * A file which does not exist is created. Returns \c true on success, otherwise \c false.
+ */
+bool ChangeSet::attach(const QString &fileName)
+{
+    return execute("ATTACH DATABASE ? AS Aenderungsdatei", QVariantList() << fileName, "attachChangeset");
+}
+
+/*!
+ * \brief Detaches the changeset file from the database connection
+ */
+void ChangeSet::detach()
+{
+    QSqlQuery query;
+    query.prepare("DETACH DATABASE Aenderungsdatei");
+    Database::exec(&query, "detachChangeset");
+}
+
+/*!
+ * \brief Prepares and executes the statement \a sql with the bound values \a values
+ *
+ * Any error is logged with \a method and kept. If \a affected is given, the number of affected entries is stored there.
+ * Returns \c true on success, otherwise \c false.
+ */
+bool ChangeSet::execute(const QString &sql, const QVariantList &values, const QString &method, int *affected)
+{
+    QSqlQuery query;
+    query.prepare(sql);
+    for(int i = 0; i < values.size(); i++) {
+        query.bindValue(i, values.at(i));
+    }
+    if(!Database::exec(&query, method)) {
+        error = query.lastError().text();
+        return false;
+    }
+    if(affected) {
+        *affected = query.numRowsAffected();
+    }
+    return true;
+}
+
+/*!
+ * \brief Adds a conflict for each result of the query \a sql
+ *
+ * The columns of each result replace the place markers \c %1 to \c %9 of \a description.
+ * The markers are replaced in a single pass, so markers within the names of the entries are kept.
+ * Returns \c true on success, otherwise \c false.
+ */
+bool ChangeSet::collectConflicts(const QString &sql, const QString &description)
+{
+    QSqlQuery query;
+    query.prepare(sql);
+    if(!Database::exec(&query, "applyChanges")) {
+        error = query.lastError().text();
+        return false;
+    }
+    while(query.next()) {
+        QStringList values;
+        for(int i = 0; i < query.record().count(); i++) {
+            values << query.value(i).toString();
+        }
+        QString text;
+        for(int pos = 0; pos < description.size(); pos++) {
+            int marker = (description.at(pos) == '%' && pos + 1 < description.size()) ? description.at(pos + 1).digitValue() : -1;
+            if(marker > 0 && marker <= values.size()) {
+                text += values.at(marker - 1);
+                pos++;
+            } else {
+                text += description.at(pos);
+            }
+        }
+        conflictList << text;
+    }
+    return true;
+}
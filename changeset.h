@@ -0,0 +1,64 @@
+/*
+ * changeset.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CHANGESET_H
+#define CHANGESET_H
+
+#include <QtSql>
+#include <QtDebug>
+#include <QFile>
+#include <QStringList>
+#include <QVariantList>
+#include "database.h"
+
+// Version of the format of the changeset files
+#define changeset_format 1
+
+class ChangeSet
+{
+public:
+    explicit ChangeSet(Database *database);
+
+    bool exportChanges(const QString &fileName, qint64 since);
+    bool apply(const QString &fileName);
+
+    int changedEntries() const;
+    int deletedEntries() const;
+    QStringList conflicts() const;
+    QString lastError() const;
+
+private:
+    Database *db;
+    int changed;
+    int deleted;
+    QStringList conflictList;
+    QString error;
+
+    bool attach(const QString &fileName);
+    void detach();
+    bool execute(const QString &sql, const QVariantList &values, const QString &method, int *affected = nullptr);
+    bool collectConflicts(const QString &sql, const QString &description);
+    bool applyEntries();
+    bool applyDeletions();
+};
+
+#endif // CHANGESET_H
@@ -0,0 +1,84 @@
+/*
+ * columnwidthestimator.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "columnwidthestimator.h"
+
+/*!
+ * \class ColumnWidthEstimator
+ *
+ * \brief Estimates the widths of the columns of a view from a sample of its longest entries
+ *
+ * Instead of measuring the text of every cell, only a bounded number of the longest values
+ * per column is taken from the database (see \l Database::sampleLongestValues()) and measured.
+ * The samples are cached per view until the contents of the database change.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \fn ColumnWidthEstimator::ColumnWidthEstimator(Database *database, int sampleSize = 20)
+ *
+ * \brief Constructs a ColumnWidthEstimator
+ *
+ * It initialises the internal database pointer \a database.
+ * At most \a sampleSize values per column are measured.
+ */
+ColumnWidthEstimator::ColumnWidthEstimator(Database *database, int sampleSize) : db(database), sampleSize(sampleSize)
+{}
+
+/*!
+ * \brief Returns the estimated widths of the columns of a view
+ *
+ * The view of name \a view is based on the query of \a selectcols from \a table (see \l Database::executeQuery()).
+ * \a columns are the names of the resulting columns, for which the widths are returned in the same order.
+ *
+ * The widths are the widths of the sampled texts with the font given by \a metrics
+ * plus the margins applied by the default item delegate.
+ */
+QVector<int> ColumnWidthEstimator::estimate(const QString &view, const QString &table, const QString &selectcols,
+                                            const QStringList &columns, const QFontMetrics &metrics)
+{
+    QHash<QString, Sample>::iterator it = cache.find(view);
+    if(it == cache.end() || it->dataVersion != db->dataVersion() || it->columns != columns) {
+        Sample sample;
+        sample.dataVersion = db->dataVersion();
+        sample.columns = columns;
+        sample.values = db->sampleLongestValues(QString("(SELECT %1 FROM %2)").arg(selectcols).arg(table), columns, sampleSize);
+        it = cache.insert(view, sample);
+    }
+
+    // The default item delegate adds the focus frame margin on both sides
+    int margin = 2 * (QApplication::style()->pixelMetric(QStyle::PM_FocusFrameHMargin) + 1);
+
+    QVector<int> widths(columns.size(), 0);
+    for(int i = 0; i < columns.size(); i++) {
+        const QStringList &values = it->values.at(i);
+        for(int j = 0; j < values.size(); j++) {
+#if QT_VERSION >= 0x050B00
+            widths[i] = qMax(widths.at(i), metrics.horizontalAdvance(values.at(j)));
+#else
+            widths[i] = qMax(widths.at(i), metrics.width(values.at(j)));
+#endif
+        }
+        widths[i] += margin;
+    }
+    return widths;
+}
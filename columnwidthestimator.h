@@ -0,0 +1,53 @@
+/*
+ * columnwidthestimator.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLUMNWIDTHESTIMATOR_H
+#define COLUMNWIDTHESTIMATOR_H
+
+#include <QApplication>
+#include <QStyle>
+#include <QFontMetrics>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include "database.h"
+
+class ColumnWidthEstimator
+{
+public:
+    ColumnWidthEstimator(Database *database, int sampleSize = 20);
+
+    QVector<int> estimate(const QString &view, const QString &table, const QString &selectcols,
+                          const QStringList &columns, const QFontMetrics &metrics);
+
+private:
+    struct Sample {
+        int dataVersion;
+        QStringList columns;
+        QVector<QStringList> values;
+    };
+
+    Database *db;
+    int sampleSize;
+    QHash<QString, Sample> cache;
+};
+
+#endif // COLUMNWIDTHESTIMATOR_H
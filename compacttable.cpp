@@ -0,0 +1,302 @@
+/*
+ * compacttable.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "compacttable.h"
+
+/*!
+ * \class CompactTable
+ *
+ * \brief Read-only table of query results stored column by column
+ *
+ * A QSqlRecord or a QSqlQueryModel keeps every single value as a QVariant.
+ * Instead, the table stores each column in one array, depending on its values:
+ * \list
+ *   \li integers, like IDs and ECTS, as packed 32 bit numbers,
+ *   \li strings by dictionary encoding, i.e. as number of the string in a dictionary of the distinct strings,
+ *       which is shared by all columns and keeps all strings in a single QString (the arena),
+ *   \li any other values as QVariant.
+ * \endlist
+ * As columns like \tt Herkunft, \tt PO or \tt Datum are highly repetitive, the table needs only a fraction of the memory.
+ *
+ * The type of a column is chosen by its first value which is not NULL.
+ * If a later value does not fit, the column falls back to QVariant storage.
+ *
+ * Copies of a table share the data until one of them is changed.
+ *
+ * \since 3.3
+ */
+
+const qint32 CompactTable::nullInteger;
+
+/*!
+ * \brief Constructs an empty table without columns
+ */
+CompactTable::CompactTable() :
+    rows(0)
+{
+    offsets << 0;
+}
+
+/*!
+ * \brief Constructs an empty table with the columns of the fields of \a header
+ */
+CompactTable::CompactTable(const QSqlRecord &header) :
+    fields(header),
+    rows(0)
+{
+    offsets << 0;
+    fields.clearValues();
+    Column column = { Empty, QVector<qint32>(), QVector<QVariant>() };
+    columns.fill(column, header.count());
+}
+
+/*!
+ * \brief Returns a table of all remaining rows of the active \a query
+ *
+ * The query is finished afterwards.
+ */
+CompactTable CompactTable::fromQuery(QSqlQuery &query)
+{
+    CompactTable table(query.record());
+    while(query.next()) {
+        table.append(query.record());
+    }
+    query.finish();
+    table.squeeze();
+    return table;
+}
+
+/*!
+ * \brief Returns a table of the \a records with the columns of \a header
+ */
+CompactTable CompactTable::fromRecords(const QSqlRecord &header, const QVector<QSqlRecord> &records)
+{
+    CompactTable table(header);
+    for(int i = 0; i < records.size(); i++) {
+        table.append(records.at(i));
+    }
+    table.squeeze();
+    return table;
+}
+
+/*!
+ * \brief Appends the values of \a record as a new row
+ *
+ * The fields of \a record are expected in the order of the columns.
+ */
+void CompactTable::append(const QSqlRecord &record)
+{
+    for(int c = 0; c < columns.size(); c++) {
+        Column &column = columns[c];
+        QVariant value = record.value(c);
+        bool isNull = value.isNull();
+
+        if(column.kind == Empty && !isNull) {
+            // The first value decides on the storage, the rows before are NULL
+            if(isInteger(value)) {
+                column.kind = Integer;
+                column.ints.fill(nullInteger, rows);
+            } else if(value.type() == QVariant::String) {
+                column.kind = Dictionary;
+                column.ints.fill(0, rows);
+            } else {
+                column.kind = Variant;
+                column.variants.resize(rows);
+            }
+        } else if((column.kind == Integer && !isNull && !isInteger(value))
+                  || (column.kind == Dictionary && !isNull && value.type() != QVariant::String)) {
+            toVariants(column);
+        }
+
+        switch(column.kind) {
+        case Empty:
+            break;
+        case Integer:
+            column.ints << (isNull ? nullInteger : value.toInt());
+            break;
+        case Dictionary:
+            column.ints << (isNull ? 0 : intern(value.toString()));
+            break;
+        case Variant:
+            column.variants << value;
+            break;
+        }
+    }
+    rows++;
+}
+
+/*!
+ * \brief Releases the memory which is only needed while appending rows
+ *
+ * Rows can still be appended afterwards, but more slowly.
+ */
+void CompactTable::squeeze()
+{
+    codes.clear();
+    codes.squeeze();
+    arena.squeeze();
+    offsets.squeeze();
+    for(int c = 0; c < columns.size(); c++) {
+        columns[c].ints.squeeze();
+        columns[c].variants.squeeze();
+    }
+}
+
+/*!
+ * \brief Returns the number of rows
+ */
+int CompactTable::rowCount() const
+{
+    return rows;
+}
+
+/*!
+ * \brief Returns the number of columns
+ */
+int CompactTable::columnCount() const
+{
+    return columns.size();
+}
+
+/*!
+ * \brief Returns the name of \a column
+ */
+QString CompactTable::fieldName(int column) const
+{
+    return fields.fieldName(column);
+}
+
+/*!
+ * \brief Returns a record with the fields of the columns, but without values
+ */
+QSqlRecord CompactTable::header() const
+{
+    return fields;
+}
+
+/*!
+ * \brief Returns the value in \a row and \a column
+ *
+ * An invalid QVariant is returned for NULL values and positions outside of the table.
+ */
+QVariant CompactTable::value(int row, int column) const
+{
+    if(row < 0 || row >= rows || column < 0 || column >= columns.size()) {
+        return QVariant();
+    }
+    const Column &col = columns.at(column);
+    switch(col.kind) {
+    case Integer: {
+        qint32 number = col.ints.at(row);
+        return (number == nullInteger) ? QVariant() : QVariant(number);
+    }
+    case Dictionary: {
+        qint32 code = col.ints.at(row);
+        if(code == 0) return QVariant();
+        int start = offsets.at(code - 1);
+        return arena.mid(start, offsets.at(code) - start);
+    }
+    case Variant:
+        return col.variants.at(row);
+    default:
+        return QVariant();
+    }
+}
+
+/*!
+ * \brief Returns the values of \a row as a record
+ */
+QSqlRecord CompactTable::record(int row) const
+{
+    QSqlRecord result = fields;
+    for(int c = 0; c < columns.size(); c++) {
+        result.setValue(c, value(row, c));
+    }
+    return result;
+}
+
+/*!
+ * \brief Returns whether \a value is an integer which can be stored in 32 bits
+ */
+bool CompactTable::isInteger(const QVariant &value)
+{
+    switch(value.type()) {
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong: {
+        bool ok;
+        qlonglong number = value.toLongLong(&ok);
+        return ok && number > nullInteger && number <= std::numeric_limits<qint32>::max();
+    }
+    default:
+        return false;
+    }
+}
+
+/*!
+ * \brief Returns the code of \a text in the dictionary
+ *
+ * The text is added to the arena if it is not contained yet.
+ * Codes start at 1, as 0 denotes NULL.
+ */
+qint32 CompactTable::intern(const QString &text)
+{
+    if(codes.isEmpty() && offsets.size() > 1) {
+        // the lookup has been released by squeeze()
+        for(qint32 code = 1; code < offsets.size(); code++) {
+            codes.insert(arena.mid(offsets.at(code - 1), offsets.at(code) - offsets.at(code - 1)), code);
+        }
+    }
+    QHash<QString, qint32>::const_iterator it = codes.constFind(text);
+    if(it != codes.constEnd()) {
+        return it.value();
+    }
+    arena.append(text);
+    offsets << arena.size();
+    qint32 code = offsets.size() - 1;
+    codes.insert(text, code);
+    return code;
+}
+
+/*!
+ * \brief Converts the values of \a column to QVariant storage
+ *
+ * This is needed when a value does not fit to the storage chosen by the first values.
+ */
+void CompactTable::toVariants(Column &column) const
+{
+    QVector<QVariant> variants;
+    variants.reserve(rows + 1);
+    for(int row = 0; row < rows; row++) {
+        qint32 number = column.ints.at(row);
+        if(column.kind == Integer) {
+            variants << ((number == nullInteger) ? QVariant() : QVariant(number));
+        } else if(number == 0) {
+            variants << QVariant();
+        } else {
+            variants << arena.mid(offsets.at(number - 1), offsets.at(number) - offsets.at(number - 1));
+        }
+    }
+    column.kind = Variant;
+    column.ints.clear();
+    column.variants = variants;
+}
@@ -0,0 +1,82 @@
+/*
+ * compacttable.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPACTTABLE_H
+#define COMPACTTABLE_H
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QSqlField>
+#include <QVariant>
+#include <QVector>
+#include <QHash>
+#include <limits>
+
+class CompactTable
+{
+public:
+    CompactTable();
+    explicit CompactTable(const QSqlRecord &header);
+
+    static CompactTable fromQuery(QSqlQuery &query);
+    static CompactTable fromRecords(const QSqlRecord &header, const QVector<QSqlRecord> &records);
+
+    void append(const QSqlRecord &record);
+    void squeeze();
+
+    int rowCount() const;
+    int columnCount() const;
+    QString fieldName(int column) const;
+    QSqlRecord header() const;
+    QVariant value(int row, int column) const;
+    QSqlRecord record(int row) const;
+
+private:
+    // How the values of a column are stored
+    enum Kind {
+        Empty,      // only NULL values so far, nothing is stored
+        Integer,    // 32 bit integers in ints, NULL as nullInteger
+        Dictionary, // strings as codes into the arena in ints, NULL as 0
+        Variant     // anything else in variants
+    };
+    struct Column {
+        Kind kind;
+        QVector<qint32> ints;
+        QVector<QVariant> variants;
+    };
+
+    static const qint32 nullInteger = std::numeric_limits<qint32>::min();
+
+    QSqlRecord fields;
+    QVector<Column> columns;
+    int rows;
+
+    // The distinct strings of all dictionary columns, one after the other
+    QString arena;
+    QVector<int> offsets;
+    QHash<QString, qint32> codes;
+
+    static bool isInteger(const QVariant &value);
+    qint32 intern(const QString &text);
+    void toVariants(Column &column) const;
+};
+
+#endif // COMPACTTABLE_H
@@ -0,0 +1,364 @@
+/*
+ * compacttablemodel.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "compacttablemodel.h"
+#include <algorithm>
+
+/*!
+ * \class CompactTableModel
+ *
+ * \brief Read-only table model displaying a CompactTable
+ *
+ * In contrast to QSqlQueryModel the model does not execute a query itself,
+ * but displays a table which has been fetched before, possibly from a cache or by another thread or connection.
+ * The column names are taken from the field names of the table.
+ *
+ * The model sorts itself, see \l sort(), so no proxy model is needed.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs an empty CompactTableModel
+ *
+ * \a parent is passed to the QAbstractTableModel constructor.
+ */
+CompactTableModel::CompactTableModel(QObject *parent) :
+    QAbstractTableModel(parent)
+{
+}
+
+/*!
+ * \brief Sets the table to be displayed to \a table
+ *
+ * Any header labels set before are discarded.
+ */
+void CompactTableModel::setTable(const CompactTable &table)
+{
+    beginResetModel();
+    contents = table;
+    headerLabels.clear();
+    rowOrder.clear();
+    rankCache.clear();
+    endResetModel();
+}
+
+/*!
+ * \brief Appends the rows of \a table to the displayed table
+ *
+ * \a table is expected to have the same columns. In contrast to \l setTable() the model is not reset,
+ * so the views keep their current and selected rows. If the model is sorted, the new rows are shown at the end.
+ * An empty model without columns takes \a table as it is.
+ *
+ * \since 3.3
+ */
+void CompactTableModel::appendTable(const CompactTable &table)
+{
+    if(contents.columnCount() == 0) {
+        setTable(table);
+        return;
+    }
+
+    int rows = table.rowCount();
+    if(rows == 0) return;
+
+    int first = contents.rowCount();
+    beginInsertRows(QModelIndex(), first, first + rows - 1);
+    for(int row = 0; row < rows; row++) {
+        contents.append(table.record(row));
+        if(!rowOrder.isEmpty()) {
+            rowOrder << first + row;
+        }
+    }
+    contents.squeeze();
+    rankCache.clear();
+    endInsertRows();
+}
+
+/*!
+ * \brief Returns the displayed table
+ */
+const CompactTable &CompactTableModel::table() const
+{
+    return contents;
+}
+
+/*!
+ * \brief Returns the values of \a row as a record
+ *
+ * \a row is a row of the model, so it is mapped to the table if the model is sorted.
+ */
+QSqlRecord CompactTableModel::record(int row) const
+{
+    return contents.record(tableRow(row));
+}
+
+/*!
+ * \brief Removes all rows and columns
+ */
+void CompactTableModel::clear()
+{
+    setTable(CompactTable());
+}
+
+/*!
+ * \brief Returns the number of rows
+ *
+ * As the model is a flat table, \c 0 is returned for any valid \a parent.
+ */
+int CompactTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : contents.rowCount();
+}
+
+/*!
+ * \brief Returns the number of columns
+ *
+ * As the model is a flat table, \c 0 is returned for any valid \a parent.
+ */
+int CompactTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : contents.columnCount();
+}
+
+/*!
+ * \brief Returns the value at \a index for the display and edit \a role
+ *
+ * For all other roles an invalid QVariant is returned.
+ */
+QVariant CompactTableModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return QVariant();
+    }
+    return contents.value(tableRow(index.row()), index.column());
+}
+
+/*!
+ * \brief Returns the label of column \a section
+ *
+ * Unless set by \l setHeaderData(), the label is the field name of the column.
+ * For the vertical \a orientation the row number is returned.
+ */
+QVariant CompactTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::EditRole)) {
+        if(headerLabels.contains(section)) {
+            return headerLabels.value(section);
+        }
+        return contents.fieldName(section);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+/*!
+ * \brief Sets the label of column \a section to \a value
+ *
+ * Only horizontal labels for the display and edit \a role can be set, then \c true is returned.
+ * Otherwise nothing is changed and \c false is returned.
+ */
+bool CompactTableModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant &value, int role)
+{
+    if(orientation != Qt::Horizontal || section < 0 || section >= contents.columnCount() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return false;
+    }
+    headerLabels.insert(section, value);
+    emit headerDataChanged(orientation, section, section);
+    return true;
+}
+
+/*!
+ * \brief Sorts the rows by \a column in \a order
+ *
+ * Strings are compared locale-aware. Their collation keys are computed only once per distinct string,
+ * which are ranked together with the numbers of the column. The ranks are cached until another table is set,
+ * so sorting the same column again (e.g. in the other order) takes a single counting sort of the rows.
+ *
+ * The sort is stable and NULL values come first. A negative \a column restores the order of the table.
+ */
+void CompactTableModel::sort(int column, Qt::SortOrder order)
+{
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+
+    QModelIndexList persistent = persistentIndexList();
+    QVector<int> persistentRows;
+    for(int i = 0; i < persistent.size(); i++) {
+        persistentRows << tableRow(persistent.at(i).row());
+    }
+
+    int rows = contents.rowCount();
+    if(column < 0 || column >= contents.columnCount()) {
+        rowOrder.clear();
+    } else {
+        if(!rankCache.contains(column)) {
+            rankCache.insert(column, sortRanks(column));
+        }
+        const QVector<int> &ranks = rankCache[column];
+        int maxRank = 0;
+        for(int row = 0; row < rows; row++) {
+            maxRank = qMax(maxRank, ranks.at(row));
+        }
+
+        // counting sort, which keeps the order of equal ranks in both orders
+        QVector<int> starts(maxRank + 2, 0);
+        for(int row = 0; row < rows; row++) {
+            int rank = (order == Qt::AscendingOrder) ? ranks.at(row) : maxRank - ranks.at(row);
+            starts[rank + 1]++;
+        }
+        for(int rank = 1; rank < starts.size(); rank++) {
+            starts[rank] += starts.at(rank - 1);
+        }
+        rowOrder.resize(rows);
+        for(int row = 0; row < rows; row++) {
+            int rank = (order == Qt::AscendingOrder) ? ranks.at(row) : maxRank - ranks.at(row);
+            rowOrder[starts[rank]++] = row;
+        }
+    }
+
+    // the persistent indexes (e.g. the selection) move with their rows
+    QVector<int> positions(rows);
+    for(int row = 0; row < rows; row++) {
+        positions[tableRow(row)] = row;
+    }
+    QModelIndexList moved;
+    for(int i = 0; i < persistent.size(); i++) {
+        moved << index(positions.at(persistentRows.at(i)), persistent.at(i).column());
+    }
+    changePersistentIndexList(persistent, moved);
+
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+/*!
+ * \brief Returns the row of the table which is displayed in \a row
+ */
+int CompactTableModel::tableRow(int row) const
+{
+    return rowOrder.isEmpty() ? row : rowOrder.at(row);
+}
+
+/*!
+ * \brief Returns the rank of each row of the table in \a column
+ *
+ * NULL values have rank 0, followed by the numbers and then by the strings in the order of the default QCollator.
+ * The collation keys of many distinct strings are computed and sorted in chunks by the threads of the global thread pool,
+ * the sorted chunks are merged afterwards.
+ */
+QVector<int> CompactTableModel::sortRanks(int column) const
+{
+    int rows = contents.rowCount();
+    QVector<int> ranks(rows, 0);
+    QVector<QPair<double, int> > numbers;
+    QStringList texts;
+    QHash<QString, int> textIndexes;
+    QVector<int> textOfRow(rows, -1);
+
+    for(int row = 0; row < rows; row++) {
+        QVariant value = contents.value(row, column);
+        if(value.isNull()) continue;
+
+        QVariant::Type type = value.type();
+        if(type == QVariant::Int || type == QVariant::UInt || type == QVariant::LongLong
+                || type == QVariant::ULongLong || type == QVariant::Double) {
+            numbers << qMakePair(value.toDouble(), row);
+        } else {
+            QString text = value.toString();
+            int textIndex = textIndexes.value(text, -1);
+            if(textIndex < 0) {
+                textIndex = texts.size();
+                textIndexes.insert(text, textIndex);
+                texts << text;
+            }
+            textOfRow[row] = textIndex;
+        }
+    }
+
+    int rank = 0;
+    std::sort(numbers.begin(), numbers.end());
+    for(int i = 0; i < numbers.size(); i++) {
+        if(i == 0 || numbers.at(i).first != numbers.at(i - 1).first) {
+            rank++;
+        }
+        ranks[numbers.at(i).second] = rank;
+    }
+
+    QList<KeyJob> jobs;
+    for(int begin = 0; begin < texts.size(); begin += sort_chunk_size) {
+        KeyJob job;
+        job.texts = &texts;
+        job.locale = QLocale();
+        job.begin = begin;
+        job.end = qMin(begin + sort_chunk_size, texts.size());
+        jobs << job;
+    }
+
+    // a single chunk is not worth starting a thread
+    QList<SortKey> keys;
+    if(jobs.size() == 1) {
+        keys = sortKeys(jobs.first());
+    } else if(jobs.size() > 1) {
+        QList<QList<SortKey> > chunks = QtConcurrent::blockingMapped<QList<QList<SortKey> > >(jobs, sortKeys);
+        for(int c = 0; c < chunks.size(); c++) {
+            int middle = keys.size();
+            keys << chunks.at(c);
+            std::inplace_merge(keys.begin(), keys.begin() + middle, keys.end(), keyLess);
+        }
+    }
+
+    QVector<int> textRanks(texts.size(), 0);
+    for(int i = 0; i < keys.size(); i++) {
+        if(i == 0 || keys.at(i).key.compare(keys.at(i - 1).key) != 0) {
+            rank++;
+        }
+        textRanks[keys.at(i).text] = rank;
+    }
+    for(int row = 0; row < rows; row++) {
+        if(textOfRow.at(row) > -1) {
+            ranks[row] = textRanks.at(textOfRow.at(row));
+        }
+    }
+    return ranks;
+}
+
+/*!
+ * \brief Returns the sorted collation keys of the strings of the chunk given by \a job
+ *
+ * Each task uses a collator of its own, as a collator must not be shared between threads.
+ */
+QList<CompactTableModel::SortKey> CompactTableModel::sortKeys(const KeyJob &job)
+{
+    QCollator collator(job.locale);
+    QList<SortKey> keys;
+    for(int i = job.begin; i < job.end; i++) {
+        SortKey key = {collator.sortKey(job.texts->at(i)), i};
+        keys << key;
+    }
+    std::sort(keys.begin(), keys.end(), keyLess);
+    return keys;
+}
+
+/*!
+ * \brief Returns \c true if the collation key of \a a is ordered before the one of \a b
+ */
+bool CompactTableModel::keyLess(const SortKey &a, const SortKey &b)
+{
+    return a.key.compare(b.key) < 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * compacttablemodel.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPACTTABLEMODEL_H
+#define COMPACTTABLEMODEL_H
+
+// Number of distinct strings whose sort keys are computed by a single task of a worker thread
+#define sort_chunk_size 8192
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QPair>
+#include <QStringList>
+#include <QLocale>
+#include <QCollator>
+#include <QtConcurrent>
+#include "compacttable.h"
+
+class CompactTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit CompactTableModel(QObject *parent = nullptr);
+
+    void setTable(const CompactTable &table);
+    void appendTable(const CompactTable &table);
+    const CompactTable &table() const;
+    QSqlRecord record(int row) const;
+    void clear();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    bool setHeaderData(int section, Qt::Orientation orientation, const QVariant &value, int role = Qt::EditRole) Q_DECL_OVERRIDE;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) Q_DECL_OVERRIDE;
+
+private:
+    // Collation key of a distinct string of a column
+    struct SortKey {
+        QCollatorSortKey key;
+        int text;
+    };
+
+    // Range of distinct strings whose keys are computed and sorted by a single task
+    struct KeyJob {
+        const QStringList *texts;
+        QLocale locale;
+        int begin;
+        int end;
+    };
+
+    CompactTable contents;
+    QHash<int, QVariant> headerLabels;
+    // Rows of the table in the displayed order, empty for the order of the table
+    QVector<int> rowOrder;
+    // Rank of each row of the table per sorted column, equal values have equal ranks
+    QHash<int, QVector<int> > rankCache;
+
+    int tableRow(int row) const;
+    QVector<int> sortRanks(int column) const;
+
+    static QList<SortKey> sortKeys(const KeyJob &job);
+    static bool keyLess(const SortKey &a, const SortKey &b);
+};
+
+#endif // COMPACTTABLEMODEL_H
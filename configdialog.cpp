@@ -73,6 +73,14 @@ void ConfigDialog::initGuiElements()
     ui->databaseComboBox->setCurrentIndex(-1);
     ui->databaseComboBox->blockSignals(false);
 
+    // Database access mode
+    ui->databaseModeComboBox->addItem(tr("Direct access to the database file"));
+    ui->databaseModeComboBox->addItem(tr("Working copy in memory, saved in the background"));
+#ifndef NATIVE_SQLITE
+    ui->databaseModeComboBox->setItemData(1, tr("This build rewrites the whole database file on every save"), Qt::ToolTipRole);
+#endif
+    ui->databaseModeComboBox->addItem(tr("Read-only snapshot, which is never changed"));
+
     //Language
     ui->languageComboBox->blockSignals(true);
     ui->languageComboBox->addItem(tr("German"), "de");
@@ -158,6 +166,30 @@ QString ConfigDialog::databaseLocation() const
 }
 
 
+/*!
+ * \brief This function sets the database access mode
+ *
+ * The combobox is set to the index \a mode (see \l ConfigManager::getDatabaseMode()).
+ *
+ * \since 3.3
+ */
+void ConfigDialog::setDatabaseMode(int mode)
+{
+    ui->databaseModeComboBox->setCurrentIndex(mode);
+}
+
+/*!
+ * \brief Returns the database access mode
+ *
+ * \return The current index of the mode combobox.
+ *
+ * \since 3.3
+ */
+int ConfigDialog::databaseMode() const
+{
+    return ui->databaseModeComboBox->currentIndex();
+}
+
 /*!
  * \brief This function sets the language of the GUI
  *
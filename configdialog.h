@@ -41,6 +41,9 @@ public:
     void setDatabaseLocation(int locId, const QString &location);
     QString databaseLocation() const;
 
+    void setDatabaseMode(int mode);
+    int databaseMode() const;
+
     void setLanguage(const QString &lang);
     QString language() const;
 
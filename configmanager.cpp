@@ -101,12 +101,16 @@ void ConfigManager::loadSettingsFile()
 /*!
  * \brief Load all (currently available) settings except database location
  *
- * It reads the settings file and then loads the language and font size settings
+ * It reads the settings file and then loads the language and font size settings.
+ * The translations of Qt itself are not loaded, see \l loadQtTranslations().
  */
 void ConfigManager::loadSettings() {
     loadSettingsFile();
+    StartupProfile::mark("settings file");
     loadLanguage();
+    StartupProfile::mark("language");
     loadFontSize();
+    StartupProfile::mark("font size");
 }
 
 /*!
@@ -199,19 +203,35 @@ QString ConfigManager::getDatabaseLocation()
 }
 
 /*!
- * \brief Loads the GUI language and instructs the translators
+ * \brief Returns the database access mode
+ *
+ * Reads the mode in which the database is accessed from the settings.
+ * Changes of the mode take effect when the database is opened the next time.
+ *
+ * The \c int values correspond to the index of the mode combobox in the ConfigDialog
+ * \list
+ *   \li 0: The database file is accessed directly
+ *   \li 1: The database file is loaded into a working copy in memory, which is written back in the background
+ *   \li 2: The database file is opened read-only as an immutable snapshot
+ * \endlist
+ *
+ * \since 3.3
+ */
+int ConfigManager::getDatabaseMode()
+{
+    return readSetting("mode", 0, "database").toInt();
+}
+
+/*!
+ * \brief Loads the GUI language and instructs the application translator
+ *
+ * Only the translation of the application itself is loaded, as it is needed for the first paint of the main window.
  */
 void ConfigManager::loadLanguage()
 {
     QLocale loc = QLocale(readSetting("language", "de", "interface").toString());
     QLocale::setDefault(loc);
 
-    if(qtTranslator->load(loc, "qt", "_", QLibraryInfo::location(QLibraryInfo::TranslationsPath))) {
-        QCoreApplication::installTranslator(qtTranslator);
-    }
-    if(qtBaseTranslator->load(loc, "qtbase", "_", QLibraryInfo::location(QLibraryInfo::TranslationsPath))) {
-        QCoreApplication::installTranslator(qtBaseTranslator);
-    }
     if(appTranslator->load(loc, "anerkennungsdb", "_", ":/translations")) {
         QCoreApplication::installTranslator(appTranslator);
     }
@@ -220,6 +240,28 @@ void ConfigManager::loadLanguage()
 
 }
 
+/*!
+ * \brief Loads the translations of the texts within Qt itself and instructs the translators
+ *
+ * Those texts only appear in standard dialogs and context menus.
+ * Therefore loading is deferred until the main window has been shown.
+ *
+ * The \tt qtbase catalog covers all modules used. Only if it is not available
+ * the \tt qt meta catalog, which loads the catalogs of further modules, is used.
+ *
+ * \since 3.3
+ */
+void ConfigManager::loadQtTranslations()
+{
+    QLocale loc = QLocale(readSetting("language", "de", "interface").toString());
+
+    if(qtBaseTranslator->load(loc, "qtbase", "_", QLibraryInfo::location(QLibraryInfo::TranslationsPath))) {
+        QCoreApplication::installTranslator(qtBaseTranslator);
+    } else if(qtTranslator->load(loc, "qt", "_", QLibraryInfo::location(QLibraryInfo::TranslationsPath))) {
+        QCoreApplication::installTranslator(qtTranslator);
+    }
+}
+
 /*!
  * \brief Loads the GUI font size and updates it
  */
@@ -246,6 +288,7 @@ void ConfigManager::execConfigDialog(QWidget *parent) {
     ConfigDialog *dlg = new ConfigDialog(parent);
     dlg->setDatabaseLocation(readSetting("locationId", 0, "database").toInt(),
                              readSetting("locationPath", "", "database").toString());
+    dlg->setDatabaseMode(getDatabaseMode());
     dlg->setLanguage(languages->value(readSetting("language", "de", "interface").toString()));
 
     dlg->setFontSize(readSetting("fontsize", QApplication::font().pointSize(), "interface").toInt());
@@ -255,6 +298,7 @@ void ConfigManager::execConfigDialog(QWidget *parent) {
         int sepidx = dblocraw.indexOf(":::");
         writeSetting("locationId",dblocraw.left(sepidx), "database");
         writeSetting("locationPath", dblocraw.remove(0,sepidx + 3), "database");
+        writeSetting("mode", dlg->databaseMode(), "database");
 
         writeSetting("language", dlg->language(), "interface");
 
@@ -32,6 +32,7 @@
 #include <QLocale>
 #include <QTranslator>
 #include "configdialog.h"
+#include "startupprofile.h"
 
 class ConfigManager: public QObject
 {
@@ -47,6 +48,7 @@ public:
     void removeGroupSettings(const QString &group);
 
     QString getDatabaseLocation();
+    int getDatabaseMode();
 
     void execConfigDialog(QWidget *parent);
 
@@ -55,6 +57,9 @@ public:
 
     void loadSettings();
 
+public slots:
+    void loadQtTranslations();
+
 private:
     QSettings *persistentConfig;
 
@@ -39,27 +39,31 @@ CSVWriter::CSVWriter(Database *database, QWidget *parent) : db(database), parent
 {}
 
 /*!
- * \fn CSVWriter::writeCSV(QFile &file, const QString &tablename, const QString &selectcols = "*")
+ * \fn CSVWriter::writeCSV(QFile &file, const QString &tablename, const QString &selectcols = "*", const SearchFilter &filter = SearchFilter())
  *
  * \brief Write a database table to a csv file
  *
  * The function write a database table with name \a tablename to the file \a file.
  * If \a selectcols is not specified, then all columns are written, otherwise only the ones in \a selectocls.
  * They need to be given in a manner that is understood by a SQL select command.
+ * The entries can be restricted by \a filter as in \l Database::executeQuery().
  *
  * The text in each cell is wrapped in double quotes and columns are separated by a semi-colon.
  * This corresponds to the usual German csv setting.
+ *
+ * It returns the number of entries written or -1 if the file is not writable.
  */
-void CSVWriter::writeCSV(QFile &file, const QString &tablename, const QString &selectcols) {
+int CSVWriter::writeCSV(QFile &file, const QString &tablename, const QString &selectcols, const SearchFilter &filter) {
 
+    int count = 0;
     if (!file.open(QIODevice::WriteOnly)) {
 
         QMessageBox::warning(parentWidget, QObject::tr("Target file is not writable."),file.errorString());
-        return;
+        return -1;
 
     } else {
 
-        QSqlQuery selectquery = db->executeQuery(tablename, QStringList(), QStringList(), selectcols);
+        QSqlQuery selectquery = db->executeQuery(tablename, filter, selectcols);
         if(selectquery.lastError().isValid()) {
             qCritical() << QObject::tr("Error in query 'selectquery':") << selectquery.lastError();
         }
@@ -85,10 +89,11 @@ void CSVWriter::writeCSV(QFile &file, const QString &tablename, const QString &s
                 textrow << wrapquotes.arg(selectquery.value(i).toString());
             }
             filestream << textrow.join(";") + "\n";
+            count++;
         }
         file.close();
 
     }
-
+    return count;
 }
 
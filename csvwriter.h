@@ -38,7 +38,8 @@ private:
 public:
     CSVWriter(Database *database, QWidget *parent = 0);
 
-    void writeCSV(QFile &file, const QString &tablename, const QString &selectcols = "*");
+    int writeCSV(QFile &file, const QString &tablename, const QString &selectcols = "*",
+                 const SearchFilter &filter = SearchFilter());
 };
 
 #endif // CSVWRITER_H
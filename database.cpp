@@ -32,12 +32,15 @@
  * \since 1.0
  */
 
+// Waiting for locks held by other instances, shared by all connections of the application
+Database::LockWait Database::lockWait = { QElapsedTimer(), false, false, 0, 0, 0, 0 };
+
 /*!
  * \brief Constructs the Database object
  *
  * It registers the database
  */
-Database::Database()
+Database::Database() : changeCounter(0), persister(nullptr), readOnly(false), externalVersion(-1), externalChangeId(-1), graphVersion(-1)
 {
     SqliteDatabase = QSqlDatabase::addDatabase("QSQLITE");
 }
@@ -62,39 +65,151 @@ QString Database::getDBFilePath() {
     return ConfigManager::getInstance()->getDatabaseLocation() + QDir::separator() + "anerkennungen.sqlite";
 }
 
+/*!
+ * \brief Returns the URI to open the database file as read-only immutable snapshot
+ *
+ * The URI needs to be opened with the connect option \c QSQLITE_OPEN_URI.
+ *
+ * \since 3.3
+ */
+QString Database::getSnapshotUri() {
+    QUrl uri = QUrl::fromLocalFile(getDBFilePath());
+    uri.setQuery("mode=ro&immutable=1");
+    return uri.toString(QUrl::FullyEncoded);
+}
+
 /*!
  * \brief Closes the database
  *
+ * In the in-memory mode all changes are written to the database file before.
+ *
  * Returns \c true if the closing of the database was successful, otherwise \c false
  */
 bool Database::closeDatabase()
 {
+    bool success = flush();
+    delete persister;
+    persister = nullptr;
+    transferGraph.clear();
+    graphVersion = -1;
+    nameIndexes.clear();
+    nameIndexVersions.clear();
+    fuzzyMatchers.clear();
+    fuzzyMatcherVersions.clear();
     SqliteDatabase.close();
     qDebug() << QObject::tr("Connection to database closed");
-    return true;
+    if(lockWait.count > 0) {
+        qDebug() << QObject::tr("Waited %1 times for locks of other instances: %2 ms in total, %3 ms at most")
+                    .arg(lockWait.count).arg(lockWait.total).arg(lockWait.longest);
+    }
+    return success;
 }
 
 /*!
  * \brief Opens the database
  *
  * Returns \c true if the database could be opened, otherwise \c false and a dialog is presented with the given error.
- * Furthermore, the database is initiliased.
+ * Furthermore, the foreign_keys pragma is set and the database is initiliased.
+ *
+ * If the in-memory mode is configured, the database file is loaded into an in-memory database,
+ * to which all queries go. The changes are written back by a \l DatabasePersister.
+ *
+ * When accessing the database file directly, the driver waits up to \c busy_max_wait ms for locks held by other instances.
+ * If the native SQLite library is available (see DatabasePersister::isNativeAvailable()), busyHandler() waits instead
+ * and keeps statistics about the waits. Otherwise the waits are estimated by timeLockWait().
  *
- * \sa initDatabase()
+ * In the read-only snapshot mode the database file is opened as immutable with memory-mapped I/O.
+ * As SQLite then neither locks the file nor reads a journal, any number of instances can share it.
+ * No migrations are possible in this mode, so a snapshot with an outdated schema is rejected.
+ *
+ * The initialisation and the migrations, which need to probe the table scheme,
+ * are skipped if the schema version stored in the database is already the current one.
+ * If a migration fails, a dialog is presented with the error and \c false is returned.
+ *
+ * \sa initDatabase(), DBMigrator
  */
 bool Database::openDatabase()
 {
     qsrand(static_cast<uint>(QTime::currentTime().msec()));
-    SqliteDatabase.setDatabaseName(getDBFilePath());
+    int mode = ConfigManager::getInstance()->getDatabaseMode();
+    bool inMemory = (mode == 1);
+    readOnly = (mode == 2);
+    if(readOnly) {
+        // The snapshot is never changed while it is open, so SQLite can skip locking and the journal entirely
+        SqliteDatabase.setConnectOptions("QSQLITE_OPEN_URI;QSQLITE_OPEN_READONLY");
+        SqliteDatabase.setDatabaseName(getSnapshotUri());
+    } else if(inMemory) {
+        SqliteDatabase.setConnectOptions("QSQLITE_OPEN_URI");
+        SqliteDatabase.setDatabaseName(DatabasePersister::workingCopyName());
+    } else {
+        // Other instances might write to the same file, so wait for their locks instead of failing at once
+        SqliteDatabase.setConnectOptions(QString("QSQLITE_BUSY_TIMEOUT=%1").arg(busy_max_wait));
+        SqliteDatabase.setDatabaseName(getDBFilePath());
+    }
 
     if (!SqliteDatabase.open()) {
         QMessageBox::critical(nullptr, QObject::tr("Connection to database failed"),
                              QObject::tr("An error occured on opening the database connection: %1").arg(SqliteDatabase.lastError().text()));
         return false;
     }
+    if(inMemory) {
+        // Working copy in memory, which is written back to the file by the persister
+        if(!DatabasePersister::load(SqliteDatabase, getDBFilePath())) {
+            QMessageBox::critical(nullptr, QObject::tr("Connection to database failed"),
+                                  QObject::tr("The database could not be loaded into memory."));
+            SqliteDatabase.close();
+            return false;
+        }
+        persister = new DatabasePersister(SqliteDatabase, getDBFilePath());
+    }
+    lockWait.timed = !inMemory && !readOnly;
+#ifdef NATIVE_SQLITE
+    if(lockWait.timed && DatabasePersister::isNativeAvailable(SqliteDatabase)) {
+        // The busy handler replaces the busy timeout of the driver and keeps statistics about the waits
+        sqlite3_busy_handler(DatabasePersister::handle(SqliteDatabase), &Database::busyHandler, nullptr);
+        lockWait.timed = false;
+    }
+#endif
+    externalVersion = -1;
+    externalChangeId = -1;
     qDebug() << QObject::tr("Connection to database successful");
-    initDatabase();
-    TimestampAdditionMigration();
+    StartupProfile::mark("open database");
+
+    QSqlQuery query;
+    query.exec("PRAGMA foreign_keys = ON");
+    int version = getSchemaVersion();
+    if(readOnly) {
+        query.exec(QString("PRAGMA mmap_size = %1").arg(snapshot_mmap_size));
+        if(version < DBMigrator::latestVersion()) {
+            // A snapshot cannot be migrated, it needs to be created by the current version
+            QMessageBox::critical(nullptr, QObject::tr("Connection to database failed"),
+                                  QObject::tr("The read-only snapshot has an outdated format. "
+                                              "Please open it once in the direct access mode to update it."));
+            closeDatabase();
+            return false;
+        }
+    } else if(version < DBMigrator::latestVersion()) {
+        // new databases and those of version 3.2 or earlier
+        if(version == 0) {
+            initDatabase();
+        }
+        DBMigrator migrator(SqliteDatabase);
+        if(!migrator.migrate(version)) {
+            QMessageBox::critical(nullptr, QObject::tr("Database migration failed"),
+                                  QObject::tr("The database could not be updated to the current version: %1").arg(migrator.lastError()));
+            closeDatabase();
+            return false;
+        }
+        if(persister) {
+            persister->markDirty();
+        }
+    }
+    StartupProfile::mark("database schema");
+
+    // the contents might be entirely different from the previously opened database
+    changeCounter++;
+    getTransferGraph();
+    StartupProfile::mark("transfer graph");
     return true;
 }
 
@@ -106,18 +221,30 @@ bool Database::openDatabase()
  * The main purpose of this function is uniformly check and report errors, which might be present in the \a query object itself
  * (e.g.,a failed bindValue() call in case of a corrupt table scheme) or which might be present after the execution.
  * Furthermore by the QString \a method the respective calling function is stored and added to the error log.
+ *
+ * Returns \c true if no error occurred, otherwise \c false.
  * \param query
  * \param method
  */
-void Database::exec(QSqlQuery *query, const QString &method)
+bool Database::exec(QSqlQuery *query, const QString &method)
 {
-
+    bool success = true;
     if(query->lastError().isValid()) {
         qCritical() << QObject::tr("Database error in '%1': %2").arg(method).arg(query->lastError().text());
+        success = false;
     }
+    QElapsedTimer timer;
+    timer.start();
     if(!query->exec()) {
         qCritical() << QObject::tr("Database error in '%1': %2").arg(method).arg(query->lastError().text());
+        success = false;
     }
+    if(lockWait.timed) {
+        timeLockWait(timer, query->isSelect(), query->lastError());
+    } else {
+        finishLockWait();
+    }
+    return success;
 }
 
 /*!
@@ -125,13 +252,11 @@ void Database::exec(QSqlQuery *query, const QString &method)
  *
  * It returns \c true if init successful and otherwise \c false.
  *
- * This function makes sure that the foreign_keys pragma is set.
- * Furthermore, it creates all necessary tables and views if they are not present within the database
+ * This function creates all necessary tables and views if they are not present within the database
  */
 bool Database::initDatabase() {
 
     QSqlQuery query;
-    query.exec("PRAGMA foreign_keys = ON");
 
     // Init tables
     QStringList tableList = SqliteDatabase.tables(QSql::Tables);
@@ -193,7 +318,7 @@ bool Database::initDatabase() {
 }
 
 /*!
- * \fn executeQuery(const QString &table, const QStringList &addcols = QStringList(), const QStringList &addvals = QStringList(), const QString &selectcols = "*", const QStringList &connectrelation = QStringList())
+ * \fn executeQuery(const QString &table, const SearchFilter &filter = SearchFilter(), const QString &selectcols = "*")
  *
  * \brief Returns an executed SELECT query QSqlQuery object
  *
@@ -201,67 +326,88 @@ bool Database::initDatabase() {
  * If \a selectcols is not specified, then all columns are included, otherwise only the ones in \a selectocls.
  * They need to be given in a manner that is understood by a SQL select command.
  *
- * If \a addcols and \a addvals are specified they need to be of the same length (otherwise the query is not executed).
- * They are used in the WHERE statement where \a addcols give the column names and \a addvals are the respective values.
- *
- * In the QStringList \a connectrelation it is stored how the entries in \a addcols are to be connected.
- * If the argument is missing they are connected by \c AND.
+ * The entries are restricted by \a filter, whose clause is used in the WHERE statement and whose values are bound to it.
+ * An empty filter selects all entries.
  *
  * The constructed and executed \c QSqlQuery object is returned.
  */
-QSqlQuery Database::executeQuery(const QString &table, const QStringList &addcols, const QStringList &addvals, const QString &selectcols, const QStringList &connectrelation)
+QSqlQuery Database::executeQuery(const QString &table, const SearchFilter &filter, const QString &selectcols)
 {
     QSqlQuery query;
-    if(addcols.size() != addvals.size()) {
-        query.finish();
-        return query;
-    }
-    QString rel;
-    bool isgrouped = false;
     QString sql = QString("SELECT ");
     sql += selectcols;
     sql += " FROM ";
     sql += table;
-    if(!addcols.isEmpty()) {
-        sql += " WHERE (";
-        for(int i = 0; i < addcols.size(); i++) {
-            if(i>0) {
-                rel = connectrelation.value(i-1, " AND ");
-                if(rel.contains('(')) {
-                    isgrouped = true;
-                }
-                sql += rel;
-            }
-            sql += addcols.at(i);
-            sql += "?";
-            if(addcols.at(i).contains(" LIKE ")) {
-                sql += " ESCAPE '!'";
-            }
-        }
-        sql += ")";
-        if(isgrouped) {
-            sql += ")";
-        }
+    if(!filter.isEmpty()) {
+        sql += " WHERE ";
+        sql += filter.sql();
     }
 
     query.prepare(sql);
-    int idx = 0;
-
-    if(!(addcols.isEmpty() || addvals.isEmpty())) {
-        QString bindparam;
-        for(int i = 0; i < addvals.size(); i++) {
-            bindparam = addvals.at(i);
-            if(bindparam.isEmpty()) {
-                query.bindValue(idx++, QVariant(QVariant::String));
-            } else {
-                query.bindValue(idx++, bindparam);
-            }
-        }
+    QVariantList values = filter.values();
+    for(int i = 0; i < values.size(); i++) {
+        query.bindValue(i, values.at(i));
     }
     exec(&query, "executeQuery");
     return query;
 }
 
+/*!
+ * \brief Returns all rows of a query as CompactTable, possibly from the cache
+ *
+ * The arguments \a table, \a filter and \a selectcols are the same as for \l executeQuery().
+ *
+ * Results are kept in a cache until the contents of the database change, see \l dataVersion(),
+ * so that repeating a query, e.g. when switching back to a view, does not access the database.
+ * Failed queries are not cached.
+ *
+ * \since 3.3
+ */
+CompactTable Database::fetchTable(const QString &table, const SearchFilter &filter, const QString &selectcols)
+{
+    CompactTable result;
+    QString key = QueryCache::key(table, filter, selectcols);
+    if(queryCache.lookup(key, changeCounter, result)) {
+        return result;
+    }
+
+    QSqlQuery query = executeQuery(table, filter, selectcols);
+    if(!query.isActive()) {
+        return result;
+    }
+    result = CompactTable::fromQuery(query);
+    queryCache.insert(key, changeCounter, result);
+    return result;
+}
+
+/*!
+ * \brief Returns whether the result of a query is present in the cache
+ *
+ * The arguments are the same as for \l executeQuery().
+ *
+ * \since 3.3
+ */
+bool Database::isCached(const QString &table, const SearchFilter &filter, const QString &selectcols)
+{
+    return queryCache.contains(QueryCache::key(table, filter, selectcols), changeCounter);
+}
+
+/*!
+ * \brief Stores the result of a query which has been fetched elsewhere in the cache
+ *
+ * The arguments \a table, \a filter and \a selectcols identify the query as for \l executeQuery(),
+ * \a header contains its field names and \a records its rows.
+ * The result is only stored if \a version, the data version it was fetched for, is still the current one.
+ *
+ * \since 3.3
+ */
+void Database::cacheRecords(const QString &table, const SearchFilter &filter, const QString &selectcols,
+                            int version, const QSqlRecord &header, const QVector<QSqlRecord> &records)
+{
+    if(version != changeCounter) return;
+    queryCache.insert(QueryCache::key(table, filter, selectcols), version, CompactTable::fromRecords(header, records));
+}
+
 /*!
  * \brief Removes an entry from a table
  *
@@ -271,10 +417,19 @@ QSqlQuery Database::executeQuery(const QString &table, const QStringList &addcol
  */
 int Database::deleteEntry(const QString &table, const QString &id )
 {
+    bool graphCurrent = (graphVersion == changeCounter);
     QSqlQuery query;
     query.prepare("DELETE FROM " + table + " WHERE ID=?");
     query.bindValue(0, id );
     exec(&query, "deleteEntry");
+    contentChanged();
+    // a deleted transfer is removed from the graph, any other deletion lets it be loaded again
+    if(graphCurrent && table == "Anerkennungen") {
+        if(query.numRowsAffected() > 0) {
+            transferGraph.removeTransfer(id.toInt());
+        }
+        graphVersion = changeCounter;
+    }
     return query.numRowsAffected();
 }
 
@@ -282,14 +437,17 @@ int Database::deleteEntry(const QString &table, const QString &id )
  * \brief Updates an entry in a table
  *
  * This function updates the entry with ID \a id in table of name \a table.
- * The columns to be updated are given in \a updcols and the according values in \a updvals.
+ * The columns to be updated are given in \a columns and the according values in \a values.
  * If the lengths of those 2 QStringLists are different then no update is performed.
+ * Origins and POs are given by their names, see \l resolveLookups().
  *
  * It returns the number of entries actually updated or -1 if no update was performed.
  */
-int Database::updateEntry(const QString &table, const QStringList &updcols, const QStringList &updvals, const QString &id)
+int Database::updateEntry(const QString &table, const QStringList &columns, const QStringList &values, const QString &id)
 {
-    if(updcols.size() == updvals.size()) {
+    if(columns.size() == values.size()) {
+        QStringList updcols(columns), updvals(values);
+        resolveLookups(table, updcols, updvals);
 
         QSqlQuery query;
         QString bindparam;
@@ -301,7 +459,7 @@ int Database::updateEntry(const QString &table, const QStringList &updcols, cons
             sql += updcols.at(i);
             sql += "=?";
         }
-        sql += ",Datum=? WHERE ID=?";
+        sql += ",Zeit=? WHERE ID=?";
         query.prepare(sql);
         int idx = 0;
         for(int i = 0; i < updvals.size(); i++) {
@@ -312,9 +470,10 @@ int Database::updateEntry(const QString &table, const QStringList &updcols, cons
                 query.bindValue(idx++, bindparam);
             }
         }
-        query.bindValue(idx++, getTimestamp());
+        query.bindValue(idx++, currentEpoch());
         query.bindValue(idx++, id);
         exec(&query, "updateEntry");
+        contentChanged();
         return query.numRowsAffected();
     }
     return -1;
@@ -325,19 +484,22 @@ int Database::updateEntry(const QString &table, const QStringList &updcols, cons
  *
  * This function inserts an entry into table of name \a table.
  *
- * The columns to be inserted are given in \a updcols and the according values in \a updvals.
+ * The columns to be inserted are given in \a columns and the according values in \a values.
  * If the lengths of those 2 QStringLists are different then no insert is performed.
  * Columns not present in those lists are to be filled by default values (according to the SQLite database implementation).
+ * Origins and POs are given by their names, see \l resolveLookups().
  *
  * It returns the number of entries actually inserted or -1 if no insert was performed.
  */
-int Database::insertEntry(const QString &table, const QStringList &updcols, const QStringList &updvals)
+int Database::insertEntry(const QString &table, const QStringList &columns, const QStringList &values)
 {
-    if(updcols.size() == updvals.size()) {
+    if(columns.size() == values.size()) {
+        QStringList updcols(columns), updvals(values);
+        resolveLookups(table, updcols, updvals);
 
         QSqlQuery query;
         QString bindparam;
-        QString sql = QString("INSERT INTO %1 (%2,Datum) VALUES (%3,?)").arg(table).arg(updcols.join(",")).arg(QString("?,").repeated(updcols.size()-1).append("?"));
+        QString sql = QString("INSERT INTO %1 (%2,Zeit,Erstellt) VALUES (%3,?,?)").arg(table).arg(updcols.join(",")).arg(QString("?,").repeated(updcols.size()-1).append("?"));
         query.prepare(sql);
         for(int i = 0; i < updvals.size(); i++) {
             bindparam = updvals.at(i);
@@ -347,25 +509,206 @@ int Database::insertEntry(const QString &table, const QStringList &updcols, cons
                 query.bindValue(i, bindparam);
             }
         }
-        query.bindValue(updvals.size(), getTimestamp());
+        qint64 epoch = currentEpoch();
+        query.bindValue(updvals.size(), epoch);
+        query.bindValue(updvals.size() + 1, epoch);
+        int previousVersion = changeCounter;
+        bool graphCurrent = (graphVersion == changeCounter);
         exec(&query, "insertEntry");
+        contentChanged();
+        // an inserted transfer is added to the graph, any other insertion lets it be loaded again
+        if(graphCurrent && table == "Anerkennungen" && query.numRowsAffected() > 0
+                && addToTransferGraph(query.lastInsertId(), updcols, updvals)) {
+            graphVersion = changeCounter;
+        }
+        QVector<QVariant> ids;
+        QVector<QStringList> rows;
+        if(query.numRowsAffected() > 0) {
+            ids << query.lastInsertId();
+            rows << values;
+        }
+        addToNameIndexes(table, previousVersion, columns, ids, rows);
         return query.numRowsAffected();
     }
     return -1;
 }
 
+/*!
+ * \brief Insert several entries into a table
+ *
+ * This function inserts one entry for each element of \a rows into the table of name \a table.
+ * The columns to be inserted are given in \a updcols and each element of \a rows holds the according values.
+ *
+ * All entries are inserted within a single transaction and share the same time of creation, see \l currentEpoch().
+ * If any of them cannot be inserted, none is.
+ *
+ * It returns the number of entries inserted or -1 if no insert was performed.
+ *
+ * \since 3.3
+ */
+int Database::insertEntries(const QString &table, const QStringList &updcols, const QVector<QStringList> &rows)
+{
+    for(int i = 0; i < rows.size(); i++) {
+        if(rows.at(i).size() != updcols.size()) {
+            return -1;
+        }
+    }
+    if(updcols.isEmpty() || !SqliteDatabase.transaction()) {
+        return -1;
+    }
+
+    QSqlQuery query;
+    QString bindparam;
+    qint64 epoch = currentEpoch();
+    int inserted = 0;
+    int previousVersion = changeCounter;
+    bool graphCurrent = (graphVersion == changeCounter);
+    QVector<QVariant> ids;
+    for(int r = 0; r < rows.size(); r++) {
+        QStringList inscols(updcols), updvals(rows.at(r));
+        resolveLookups(table, inscols, updvals);
+        if(r == 0) {
+            query.prepare(QString("INSERT INTO %1 (%2,Zeit,Erstellt) VALUES (%3,?,?)").arg(table).arg(inscols.join(",")).arg(QString("?,").repeated(inscols.size()-1).append("?")));
+        }
+        for(int i = 0; i < updvals.size(); i++) {
+            bindparam = updvals.at(i);
+            if(bindparam.isEmpty()) {
+                query.bindValue(i, QVariant(QVariant::String));
+            } else {
+                query.bindValue(i, bindparam);
+            }
+        }
+        query.bindValue(updvals.size(), epoch);
+        query.bindValue(updvals.size() + 1, epoch);
+        if(!exec(&query, "insertEntries")) {
+            SqliteDatabase.rollback();
+            return -1;
+        }
+        inserted += query.numRowsAffected();
+        ids << query.lastInsertId();
+    }
+    QElapsedTimer timer;
+    timer.start();
+    bool committed = SqliteDatabase.commit();
+    if(lockWait.timed) {
+        timeLockWait(timer, false, SqliteDatabase.lastError());
+    }
+    if(!committed) {
+        qCritical() << QObject::tr("Error in insertEntries:") << SqliteDatabase.lastError();
+        SqliteDatabase.rollback();
+        return -1;
+    }
+    contentChanged();
+    // the inserted transfers are added to the graph
+    if(graphCurrent && table == "Anerkennungen") {
+        bool added = true;
+        for(int r = 0; r < rows.size() && added; r++) {
+            added = addToTransferGraph(ids.at(r), updcols, rows.at(r));
+        }
+        if(added) {
+            graphVersion = changeCounter;
+        }
+    }
+    addToNameIndexes(table, previousVersion, updcols, ids, rows);
+    return inserted;
+}
+
+/*!
+ * \brief Replaces the names of origins and POs by their IDs
+ *
+ * The origin of a course and the PO of a module are stored in the lookup tables \tt Herkunft and \tt PO,
+ * which are referenced by the columns \tt HID and \tt POID.
+ * If the columns \a cols of table \a table contain \tt Herkunft or \tt PO, they are replaced by the referencing column
+ * and the according names in \a vals by their IDs. Names not present yet are added to the lookup tables.
+ *
+ * \since 3.3
+ * \sa lookupId()
+ */
+void Database::resolveLookups(const QString &table, QStringList &cols, QStringList &vals)
+{
+    for(int i = 0; i < cols.size() && i < vals.size(); i++) {
+        if(table == "Kurse" && cols.at(i) == "Herkunft") {
+            cols[i] = "HID";
+            vals[i] = lookupId("Herkunft", vals.at(i));
+        } else if(table == "Module" && cols.at(i) == "PO") {
+            cols[i] = "POID";
+            vals[i] = lookupId("PO", vals.at(i));
+        }
+    }
+}
+
+/*!
+ * \brief Returns the ID of the name \a name in the lookup table \a lookupTable
+ *
+ * The name is inserted if it is not present yet.
+ * An empty QString is returned for an empty \a name, which is stored as NULL.
+ *
+ * \since 3.3
+ */
+QString Database::lookupId(const QString &lookupTable, const QString &name)
+{
+    if(name.isEmpty()) {
+        return QString();
+    }
+    QSqlQuery query;
+    query.prepare(QString("INSERT OR IGNORE INTO %1 (Name) VALUES (?)").arg(lookupTable));
+    query.bindValue(0, name);
+    exec(&query, "lookupId");
+    query.prepare(QString("SELECT ID FROM %1 WHERE Name = ?").arg(lookupTable));
+    query.bindValue(0, name);
+    if(!exec(&query, "lookupId") || !query.next()) {
+        return QString();
+    }
+    return query.value(0).toString();
+}
+
+/*!
+ * \brief Returns the table or view to display the entries of table \a table
+ *
+ * The courses and modules are displayed by the views \tt kursliste and \tt modulliste,
+ * which show the names of the origins and POs instead of their IDs.
+ * The transfers are displayed by the view \tt anerkennungsliste.
+ * All of them show the time of the last modification as local time in the column \tt Datum.
+ * For all other tables \a table itself is returned.
+ *
+ * \since 3.3
+ */
+QString Database::displayTable(const QString &table)
+{
+    if(table == "Kurse") {
+        return "kursliste";
+    }
+    if(table == "Module") {
+        return "modulliste";
+    }
+    if(table == "Anerkennungen") {
+        return "anerkennungsliste";
+    }
+    return table;
+}
+
 /*!
  * \brief Count number of entries in a table
  *
  * This function counts the number of entries in table of name \a table.
  *
  * If \a addcols and \a addvals are present and of same length, they are incorporated into a WHERE-clause.
+ * Otherwise the number is read from the table \tt Zaehler, if it is counted there, instead of scanning the whole table.
  *
  * This functions returns the number of entries as \c int.
  */
 int Database::countEntries(const QString &table, const QStringList &addcols, const QStringList &addvals)
 {
     QSqlQuery query;
+    if(addcols.isEmpty() || addvals.isEmpty()) {
+        query.prepare("SELECT Anzahl FROM Zaehler WHERE Tabelle = ?");
+        query.bindValue(0, table);
+        exec(&query, "countEntries");
+        if(query.next()) {
+            return query.value(0).toInt();
+        }
+        query.finish();
+    }
     QString bindparam;
     QString sql = "SELECT COUNT(*) FROM ";
     sql += table;
@@ -395,96 +738,610 @@ int Database::countEntries(const QString &table, const QStringList &addcols, con
 }
 
 /*!
- * \brief Timestamp database migration
+ * \brief Returns an executed query of the entries whose name starts with a prefix
  *
- * This function performs the database migration of adding a column 'Datum'
- * containing the timestamp of modification to all tables.
+ * This function selects the columns \a selectcols of the first \a limit entries in table \a table
+ * whose value in column \a column starts with \a prefix, ignoring the case.
+ * The entries are ordered alphabetically by that column. A negative \a limit selects all matching entries.
+ * The first \a offset matching entries are skipped, so the entries can be read in pages.
  *
- * The views are recreated if necessary
+ * The comparison matches the case insensitive indexes on the names,
+ * so only the matching entries are visited and not the whole table.
+ */
+QSqlQuery Database::lookupEntries(const QString &table, const QString &column, const QString &prefix, const QString &selectcols, int limit, int offset)
+{
+    QString pattern = SearchFilter::escapeLike(prefix) + "%";
+
+    QSqlQuery query;
+    query.prepare(QString("SELECT %1 FROM %2 WHERE %3 LIKE ? ESCAPE '!' ORDER BY %3 COLLATE NOCASE LIMIT ? OFFSET ?").arg(selectcols, table, column));
+    query.bindValue(0, pattern);
+    query.bindValue(1, limit);
+    query.bindValue(2, offset);
+    exec(&query, "lookupEntries");
+    return query;
+}
+
+/*!
+ * \brief Returns the entries with given names
  *
- * If any modification is actually performed, the settings of the tableview column widths are also removed.
- * (otherwise it would lead to columns being visible).
+ * This function selects the columns \a selectcols of all entries in table \a table
+ * whose value in column \a column equals one of \a names, ignoring the case.
+ *
+ * The names are looked up in chunks of several hundred names per query,
+ * each one answered by the case insensitive index on the names.
  */
-bool Database::TimestampAdditionMigration()
+QList<QSqlRecord> Database::findEntriesByName(const QString &table, const QString &column, const QStringList &names, const QString &selectcols)
 {
+    // SQLite limits the number of bound parameters per statement
+    const int chunkSize = 500;
+    QList<QSqlRecord> records;
     QSqlQuery query;
-    // Has the migration already be performed?
-    query.prepare("SELECT COUNT(*) FROM DBMigration WHERE NAME=?");
-    query.bindValue(0, "timestapAddition");
-    exec(&query, "TimeStampAdditionCount");
-    query.next();
-    bool isMigrated = query.value(0).toBool();
+    for(int start = 0; start < names.size(); start += chunkSize) {
+        int count = qMin(chunkSize, names.size() - start);
+        query.prepare(QString("SELECT %1 FROM %2 WHERE %3 COLLATE NOCASE IN (%4)")
+                      .arg(selectcols).arg(table).arg(column)
+                      .arg(QString("?,").repeated(count-1).append("?")));
+        for(int i = 0; i < count; i++) {
+            query.bindValue(i, names.at(start + i));
+        }
+        exec(&query, "findEntriesByName");
+        while(query.next()) {
+            records << query.record();
+        }
+    }
+    return records;
+}
 
-    if(!isMigrated) {
+/*!
+ * \brief Returns the existing transfers among the given pairs of courses and modules
+ *
+ * Each element of \a pairs holds the ID of a course and the ID of a module.
+ * Each pair (KID, MID) which already exists in the table \tt Anerkennungen is returned.
+ *
+ * The pairs are checked in chunks of several hundred pairs per query, each pair answered by the index on (KID, MID).
+ */
+QSet<QPair<QString, QString> > Database::findTransfers(const QList<QPair<QString, QString> > &pairs)
+{
+    // SQLite limits the number of bound parameters per statement
+    const int chunkSize = 250;
+    QSet<QPair<QString, QString> > transfers;
+    QSqlQuery query;
+    for(int start = 0; start < pairs.size(); start += chunkSize) {
+        int count = qMin(chunkSize, pairs.size() - start);
+        query.prepare(QString("SELECT KID, MID FROM Anerkennungen WHERE %1")
+                      .arg(QString("(KID = ? AND MID = ?) OR ").repeated(count-1).append("(KID = ? AND MID = ?)")));
+        for(int i = 0; i < count; i++) {
+            query.bindValue(2*i, pairs.at(start + i).first);
+            query.bindValue(2*i + 1, pairs.at(start + i).second);
+        }
+        exec(&query, "findTransfers");
+        while(query.next()) {
+            transfers.insert(qMakePair(query.value(0).toString(), query.value(1).toString()));
+        }
+    }
+    return transfers;
+}
 
-        // It is not in database and thus yet to do for us.
-        bool refreshviews = false;
+/*!
+ * \brief Returns the modules whose ECTS would differ from the sum of their courses after adding transfers
+ *
+ * Each element of \a pairs holds the ID of a course and the ID of a module of a transfer to be added,
+ * which must not exist yet. For each affected module the ECTS of the new courses are summed up and
+ * added to the sum of its existing transfers, which is kept in the table \tt ModulECTS.
+ * The modules whose sum then differs from their ECTS are returned with their name, their ECTS and the sum.
+ *
+ * The sums are computed by a single grouped query per chunk of pairs; the pairs of a module are never split among chunks.
+ *
+ * \since 3.3
+ */
+QList<QSqlRecord> Database::findEctsDeviations(const QList<QPair<QString, QString> > &pairs)
+{
+    // group the pairs by their modules, so that each module is summed up within one chunk
+    QMap<QString, QStringList> coursesOfModule;
+    for(int i = 0; i < pairs.size(); i++) {
+        coursesOfModule[pairs.at(i).second] << pairs.at(i).first;
+    }
 
-        QString sqlstring("ALTER TABLE %1 ADD COLUMN Datum Text NOT NULL DEFAULT '%2'");
+    // SQLite limits the number of bound parameters per statement
+    const int chunkSize = 250;
+    QList<QSqlRecord> records;
+    QSqlQuery query;
+    QMap<QString, QStringList>::const_iterator it = coursesOfModule.constBegin();
+    while(it != coursesOfModule.constEnd()) {
+        QVariantList values;
+        while(it != coursesOfModule.constEnd() && (values.isEmpty() || values.size() / 2 + it.value().size() <= chunkSize)) {
+            for(int i = 0; i < it.value().size(); i++) {
+                values << it.value().at(i).toInt() << it.key().toInt();
+            }
+            ++it;
+        }
 
-        if(columnNotExistsForTable("Module", "Datum")) {
-            query.prepare(sqlstring.arg("Module").arg(getTimestamp()));
-            exec(&query, "ALTER TABLE Module (Timestamp)");
-            refreshviews = true;
+        query.prepare(QString("WITH Neu (KID, MID) AS (VALUES %1) "
+                              "SELECT M.Modulname AS Modulname, M.ECTS AS ECTS, IFNULL(E.KursECTS, 0) + SUM(K.ECTS) AS Summe "
+                              "FROM Neu N JOIN Kurse K ON K.ID = N.KID JOIN Module M ON M.ID = N.MID LEFT JOIN ModulECTS E ON E.ID = N.MID "
+                              "GROUP BY N.MID HAVING Summe <> M.ECTS")
+                      .arg(QString("(?, ?), ").repeated(values.size() / 2 - 1).append("(?, ?)")));
+        for(int i = 0; i < values.size(); i++) {
+            query.bindValue(i, values.at(i));
+        }
+        exec(&query, "findEctsDeviations");
+        while(query.next()) {
+            records << query.record();
         }
+    }
+    return records;
+}
+
+/*!
+ * \brief Returns samples of the longest values in columns of a table
+ *
+ * For each column in \a columns of the table (or subquery) \a table at most \a limit values are returned,
+ * which are among the longest ones of that column.
+ *
+ * The maximal lengths of all columns are determined in a single query first.
+ * Then for each column the first \a limit values of at least three quarters of the maximal length are taken,
+ * so that the scan usually ends early.
+ */
+QVector<QStringList> Database::sampleLongestValues(const QString &table, const QStringList &columns, int limit)
+{
+    QVector<QStringList> samples(columns.size());
+    if(columns.isEmpty()) {
+        return samples;
+    }
 
-        if(columnNotExistsForTable("Kurse", "Datum")) {
-            query.prepare(sqlstring.arg("Kurse").arg(getTimestamp()));
-            exec(&query, "ALTER TABLE Kurse (Timestamp)");
-            refreshviews = true;
+    QStringList maxcols;
+    for(int i = 0; i < columns.size(); i++) {
+        maxcols << QString("MAX(LENGTH(\"%1\"))").arg(columns.at(i));
+    }
+    QSqlQuery query;
+    query.prepare(QString("SELECT %1 FROM %2").arg(maxcols.join(",")).arg(table));
+    exec(&query, "sampleLongestValues");
+    if(!query.next()) {
+        return samples;
+    }
+    QVector<int> maxLengths(columns.size());
+    for(int i = 0; i < columns.size(); i++) {
+        maxLengths[i] = query.value(i).toInt();
+    }
+    query.finish();
+
+    for(int i = 0; i < columns.size(); i++) {
+        if(maxLengths.at(i) < 1) continue;
+        query.prepare(QString("SELECT \"%1\" FROM %2 WHERE LENGTH(\"%1\") >= ? LIMIT ?").arg(columns.at(i)).arg(table));
+        query.bindValue(0, maxLengths.at(i) - maxLengths.at(i) / 4);
+        query.bindValue(1, limit);
+        exec(&query, "sampleLongestValues");
+        while(query.next()) {
+            samples[i] << query.value(0).toString();
         }
+    }
+    return samples;
+}
 
-        if(columnNotExistsForTable("Anerkennungen", "Datum")) {
-            query.prepare(sqlstring.arg("Anerkennungen").arg(getTimestamp()));
-            exec(&query, "ALTER TABLE Anerkennungen (Timestamp)");
-            refreshviews = true;
+/*!
+ * \brief Returns the graph of the transfers between courses and modules
+ *
+ * The graph is loaded when the database is opened. Inserted and deleted transfers are applied to it directly,
+ * any other change of the contents lets it be loaded again on the next call.
+ *
+ * \since 3.3
+ * \sa TransferGraph
+ */
+const TransferGraph &Database::getTransferGraph()
+{
+    if(graphVersion != changeCounter) {
+        transferGraph.load(SqliteDatabase);
+        graphVersion = changeCounter;
+    }
+    return transferGraph;
+}
+
+/*!
+ * \brief Adds the transfer \a id to the transfer graph
+ *
+ * The course and the module are taken from the values \a vals of the columns \tt KID and \tt MID in \a cols.
+ * Returns \c false if they are missing, so the graph cannot be updated.
+ *
+ * \since 3.3
+ */
+bool Database::addToTransferGraph(const QVariant &id, const QStringList &cols, const QStringList &vals)
+{
+    int course = cols.indexOf("KID");
+    int module = cols.indexOf("MID");
+    if(!id.isValid() || course < 0 || module < 0 || course >= vals.size() || module >= vals.size()) {
+        return false;
+    }
+    transferGraph.addTransfer(id.toInt(), vals.at(course).toInt(), vals.at(module).toInt());
+    return true;
+}
+
+/*!
+ * \brief Returns the index of the names of the courses or modules, depending on \a table
+ *
+ * The index is loaded on the first call. Inserted courses and modules are added to it directly,
+ * any other change of the contents lets it be loaded again on the next call.
+ *
+ * \since 3.3
+ * \sa TrigramIndex
+ */
+const TrigramIndex &Database::getNameIndex(const QString &table)
+{
+    if(nameIndexVersions.value(table, -1) != changeCounter) {
+        QString sql;
+        if(table == "Kurse") {
+            sql = "SELECT K.ID, K.Kursname, H.Name, K.ECTS FROM Kurse K LEFT JOIN Herkunft H ON H.ID = K.HID";
+        } else {
+            sql = "SELECT M.ID, M.Modulname, P.Name, M.ECTS FROM Module M LEFT JOIN PO P ON P.ID = M.POID";
         }
+        nameIndexes[table].load(SqliteDatabase, sql);
+        nameIndexVersions.insert(table, changeCounter);
+    }
+    return nameIndexes[table];
+}
+
+/*!
+ * \brief Returns the matcher for typo-tolerant searches of the names of the courses or modules, depending on \a table
+ *
+ * Like the name index, the matcher is loaded on the first call and inserted courses and modules are added to it directly.
+ *
+ * \since 3.3
+ * \sa FuzzyMatcher, getNameIndex()
+ */
+const FuzzyMatcher &Database::getFuzzyMatcher(const QString &table)
+{
+    if(fuzzyMatcherVersions.value(table, -1) != changeCounter) {
+        QString sql = (table == "Kurse") ? "SELECT ID, Kursname FROM Kurse" : "SELECT ID, Modulname FROM Module";
+        fuzzyMatchers[table].load(SqliteDatabase, sql);
+        fuzzyMatcherVersions.insert(table, changeCounter);
+    }
+    return fuzzyMatchers[table];
+}
 
-        if(refreshviews){
-            // Recreate Views
-            //anerkmodule
-            query.exec("DROP VIEW anerkmodule");
-            query.prepare("CREATE VIEW anerkmodule AS "
-                          "SELECT A.MID AS ID, K.Kursname AS Kursname, K.ECTS AS ECTS, K.Herkunft AS Herkunft, K.Datum AS Datum "
-                          "FROM Anerkennungen A JOIN Kurse K ON K.ID = A.KID");
-            exec(&query, "CREATE VIEW anerkmodule (Timestamp)");
+/*!
+ * \brief Updates the name indexes and fuzzy matchers after entries have been inserted into \a table
+ *
+ * \a previousVersion is the data version before the insertion.
+ * The entries given by their IDs \a ids and their values \a rows of the columns \a cols are added
+ * to the index and the matcher of their table. Those of the other table are not affected by the insertion.
+ *
+ * \since 3.3
+ * \sa getNameIndex()
+ */
+void Database::addToNameIndexes(const QString &table, int previousVersion, const QStringList &cols,
+                                const QVector<QVariant> &ids, const QVector<QStringList> &rows)
+{
+    QStringList tables;
+    tables << "Kurse" << "Module";
+    for(int t = 0; t < tables.size(); t++) {
+        const QString &indexTable = tables.at(t);
+        bool indexCurrent = (nameIndexVersions.value(indexTable, -1) == previousVersion);
+        bool matcherCurrent = (fuzzyMatcherVersions.value(indexTable, -1) == previousVersion);
+        if(!indexCurrent && !matcherCurrent) continue;
 
-            // anerkkurse
-            query.exec("DROP VIEW anerkkurse");
-            query.prepare("CREATE VIEW anerkkurse AS "
-                          "SELECT A.KID AS ID, M.Modulname AS Modulname, M.ECTS AS ECTS, M.PO AS PO, M.Datum AS Datum "
-                          "FROM Module M JOIN Anerkennungen A ON A.MID=M.ID");
-            exec(&query,"CREATE VIEW anerkkurse (Timestamp)");
+        if(indexTable == table) {
+            int name = cols.indexOf(table == "Kurse" ? "Kursname" : "Modulname");
+            int other = cols.indexOf(table == "Kurse" ? "Herkunft" : "PO");
+            int ects = cols.indexOf("ECTS");
+            bool complete = (name > -1 && ids.size() == rows.size());
+            for(int r = 0; r < ids.size() && complete; r++) {
+                complete = ids.at(r).isValid();
+            }
+            // without the names or IDs the index is loaded again on its next use
+            if(!complete) continue;
 
-            // As we have updated some table scheme, we need to remove all the settings of the tableView to avoid inconsistencies
-            ConfigManager::getInstance()->removeGroupSettings("tableViewWidths");
+            for(int r = 0; r < rows.size(); r++) {
+                if(indexCurrent) {
+                    nameIndexes[table].insert(ids.at(r).toInt(), rows.at(r).value(name), rows.at(r).value(other), rows.at(r).value(ects).toInt());
+                }
+                if(matcherCurrent) {
+                    fuzzyMatchers[table].insert(ids.at(r).toInt(), rows.at(r).value(name));
+                }
+            }
+        }
+        if(indexCurrent) {
+            nameIndexVersions.insert(indexTable, changeCounter);
         }
+        if(matcherCurrent) {
+            fuzzyMatcherVersions.insert(indexTable, changeCounter);
+        }
+    }
+}
 
-        query.prepare("INSERT INTO DBMigration (Name,Datum) VALUES (?,?)");
-        query.bindValue(0, "timestapAddition");
-        query.bindValue(1, getTimestamp());
-        exec(&query, "TimeStampAdditionInsert");
+/*!
+ * \brief Returns the version of the database contents
+ *
+ * The returned number changes whenever entries are inserted, updated or deleted or another database is opened.
+ * It allows to invalidate any data derived from the database contents.
+ */
+int Database::dataVersion() const
+{
+    return changeCounter;
+}
+
+/*!
+ * \brief Returns whether another instance changed the database file
+ *
+ * This compares the \c data_version pragma of the connection to its value of the last call,
+ * which is a cheap check that does not read any table.
+ * If it changed, the data version is increased as well and \c true is returned.
+ * The first call after opening the database only stores the value and returns \c false.
+ *
+ * If \a tables is given, it is filled with the tables whose entries were changed since the last call,
+ * as recorded in the change log \tt Aenderungen. It is left empty if the changed tables are unknown,
+ * i.e. only entries were deleted, only tables without change log were changed or the log was pruned in the meantime.
+ *
+ * No other instance can change the in-memory working copy or the read-only snapshot,
+ * so \c false is always returned for them, see canChangeExternally().
+ *
+ * \since 3.3
+ * \sa dataVersion()
+ */
+bool Database::hasExternalChanges(QStringList *tables)
+{
+    if(!canChangeExternally()) {
+        return false;
     }
-    return true;
+    QSqlQuery query("PRAGMA data_version");
+    if(!query.next()) {
+        return false;
+    }
+    int version = query.value(0).toInt();
+    bool changed = (externalVersion > -1 && version != externalVersion);
+    externalVersion = version;
+    if(changed) {
+        changeCounter++;
+    }
+    if(!changed && externalChangeId > -1) {
+        return changed;
+    }
+
+    qint64 last = externalChangeId;
+    if(!query.exec("SELECT IFNULL(MAX(ID), 0) FROM Aenderungen") || !query.next()) {
+        return changed;
+    }
+    externalChangeId = query.value(0).toLongLong();
+    if(changed && tables && last > -1 && last <= externalChangeId) {
+        query.prepare("SELECT DISTINCT Tabelle FROM Aenderungen WHERE ID > ?");
+        query.bindValue(0, last);
+        exec(&query, "hasExternalChanges");
+        while(query.next()) {
+            tables->append(query.value(0).toString());
+        }
+    }
+    return changed;
+}
+
+/*!
+ * \brief Returns whether other instances may change the open database
+ *
+ * This is only the case when accessing the database file directly.
+ *
+ * \since 3.3
+ */
+bool Database::canChangeExternally() const
+{
+    return SqliteDatabase.isOpen() && !persister && !readOnly;
 }
 
 /*!
- * \brief This function checks for the non existence of columns in a table
+ * \brief Waits for a lock held by another instance
  *
- * It queries the table structure of \a table if the \a column exists.
- * This function returns a \c bool which is false if the column does not exists.
+ * This is the busy handler of the database connection. SQLite calls it whenever the database file is locked
+ * by another connection, with \a count being the number of previous calls for the same lock.
+ * It sleeps for 1 ms at first and then increases the interval up to 100 ms.
+ * After waiting \c busy_max_wait ms in total it gives up by returning \c 0, so that the statement fails as busy.
+ * Otherwise a non-zero value is returned to try again.
+ *
+ * The waiting times are logged by finishLockWait() and summarised when the database is closed.
+ *
+ * \since 3.3
  */
-bool Database::columnNotExistsForTable(const QString &table, const QString &column)
+int Database::busyHandler(void *data, int count)
+{
+    Q_UNUSED(data)
+    static const int delays[] = { 1, 2, 5, 10, 20, 50, 100 };
+    static const int delayCount = sizeof(delays) / sizeof(delays[0]);
+
+    if(count == 0) {
+        // a new lock, the previous one might have ended in a statement not run by exec()
+        finishLockWait();
+        lockWait.waiting = true;
+        lockWait.current = 0;
+        lockWait.timer.start();
+    }
+    if(lockWait.timer.elapsed() >= busy_max_wait) {
+        qWarning() << QObject::tr("The database is locked by another instance, giving up after %1 ms").arg(lockWait.timer.elapsed());
+        finishLockWait();
+        return 0;
+    }
+    int delay = delays[qMin(count, delayCount - 1)];
+    lockWait.current = lockWait.timer.elapsed() + delay;
+    QThread::msleep(static_cast<unsigned long>(delay));
+    return 1;
+}
+
+/*!
+ * \brief Logs the time waited for the last lock of another instance, if any
+ *
+ * \since 3.3
+ */
+void Database::finishLockWait()
+{
+    if(!lockWait.waiting) return;
+    lockWait.waiting = false;
+    lockWait.count++;
+    lockWait.total += lockWait.current;
+    lockWait.longest = qMax(lockWait.longest, lockWait.current);
+    qDebug() << QObject::tr("Waited %1 ms for a lock of another instance").arg(lockWait.current);
+}
+
+/*!
+ * \brief Estimates the time waited for a lock of another instance by a statement started with \a timer
+ *
+ * This is used instead of busyHandler() if the driver waits for the locks itself, i.e. without the native SQLite library,
+ * as then the waits cannot be observed. A statement which failed as the database was busy or locked (\a error)
+ * waited the whole time. A writing statement (not \a read) which took at least \c lock_wait_threshold ms
+ * is assumed to have waited that long, as writing the few entries of a statement takes far less time.
+ * Reading statements are not counted, as a long reading time is common for large results.
+ *
+ * So the statistics are an estimate, which might include slow writes and misses short waits.
+ *
+ * \since 3.3
+ */
+void Database::timeLockWait(const QElapsedTimer &timer, bool read, const QSqlError &error)
+{
+    qint64 elapsed = timer.elapsed();
+    // SQLITE_BUSY and SQLITE_LOCKED
+    bool busy = (error.nativeErrorCode() == "5" || error.nativeErrorCode() == "6");
+    if(busy) {
+        qWarning() << QObject::tr("The database is locked by another instance, giving up after %1 ms").arg(elapsed);
+    } else if(read || elapsed < lock_wait_threshold) {
+        return;
+    }
+    lockWait.waiting = true;
+    lockWait.current = elapsed;
+    finishLockWait();
+}
+
+/*!
+ * \brief Returns the time of the last incremental export to \a target
+ *
+ * The time is given in seconds since the epoch. Only the entries changed or deleted since then
+ * need to be exported to \a target again. If there was no export to \a target yet, -1 is returned.
+ *
+ * \since 3.3
+ * \sa setExportWatermark()
+ */
+qint64 Database::exportWatermark(const QString &target)
 {
     QSqlQuery query;
-    query.prepare(QString("PRAGMA table_info(%1)").arg(table));
-    exec(&query, "columnExists");
-    while (query.next()) {
-        if(column.compare(query.value(1).toString(), Qt::CaseInsensitive) == 0) {
-            return false;
-        }
+    query.prepare("SELECT Zeit FROM Exportstand WHERE Ziel = ?");
+    query.bindValue(0, target);
+    if(!exec(&query, "exportWatermark") || !query.next()) {
+        return -1;
     }
-    return true;
+    return query.value(0).toLongLong();
+}
+
+/*!
+ * \brief Stores \a time as the time of the last incremental export to \a target
+ *
+ * Deletions recorded before the oldest export of all targets are not needed by any of them anymore
+ * and are removed from the table \tt Geloescht. Those with a GUID are kept for the changesets
+ * until a changeset has been exported after them (target \c changeset_target).
+ * Likewise the changes before the last export of a changeset are removed from the change log \tt Aenderungen,
+ * which is only read by \l ChangeSet. As long as no changeset has been exported, both are kept.
+ *
+ * Returns \c true on success, otherwise \c false.
+ *
+ * \since 3.3
+ */
+bool Database::setExportWatermark(const QString &target, qint64 time)
+{
+    QSqlQuery query;
+    query.prepare("INSERT OR REPLACE INTO Exportstand (Ziel, Zeit) VALUES (?, ?)");
+    query.bindValue(0, target);
+    query.bindValue(1, time);
+    bool success = exec(&query, "setExportWatermark");
+    if(success) {
+        query.prepare("DELETE FROM Geloescht WHERE Zeit < (SELECT MIN(Zeit) FROM Exportstand) "
+                      "AND (GUID IS NULL OR Zeit < (SELECT Zeit FROM Exportstand WHERE Ziel = ?))");
+        query.bindValue(0, changeset_target);
+        success = exec(&query, "setExportWatermark");
+    }
+    if(success) {
+        query.prepare("DELETE FROM Aenderungen WHERE Zeit < (SELECT Zeit FROM Exportstand WHERE Ziel = ?)");
+        query.bindValue(0, changeset_target);
+        success = exec(&query, "setExportWatermark");
+    }
+    contentChanged();
+    return success;
+}
+
+/*!
+ * \brief Registers a change of the database contents
+ *
+ * The data version is increased and in the in-memory mode the writing of the changes is scheduled.
+ */
+void Database::contentChanged()
+{
+    changeCounter++;
+    if(persister) {
+        persister->markDirty();
+    }
+}
+
+/*!
+ * \brief Returns whether the database is an in-memory working copy of the database file
+ */
+bool Database::isInMemory() const
+{
+    return persister != nullptr;
+}
+
+/*!
+ * \brief Returns whether the database is opened as read-only snapshot
+ *
+ * No entries can be added, modified or deleted in this case.
+ *
+ * \since 3.3
+ */
+bool Database::isReadOnly() const
+{
+    return readOnly;
+}
+
+/*!
+ * \brief Returns the persister of the in-memory working copy
+ *
+ * A null pointer is returned if the database file is accessed directly.
+ */
+DatabasePersister *Database::getPersister() const
+{
+    return persister;
+}
+
+/*!
+ * \brief Makes sure that the database file contains all changes
+ *
+ * In the in-memory mode the pending changes are written to the file at once, otherwise nothing needs to be done.
+ * This is needed before the database file is accessed directly.
+ * Returns \c true if the database file is up to date.
+ */
+bool Database::flush()
+{
+    return persister ? persister->flush() : true;
+}
+
+/*!
+ * \brief Returns the schema version stored in the database
+ *
+ * The version is kept in the user_version pragma, which is \c 0 for new databases
+ * and for databases which have not been opened by version 3.3 or later.
+ */
+int Database::getSchemaVersion()
+{
+    QSqlQuery query;
+    query.prepare("PRAGMA user_version");
+    exec(&query, "getSchemaVersion");
+    if(query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
+
+/*!
+ * \brief Returns the current time in seconds since the epoch
+ *
+ * The times of creation and of the last modification of the entries are stored this way in the columns
+ * \tt Erstellt and \tt Zeit, which are indexed. It is determined once for each insert or update,
+ * so all entries inserted at once share the same time.
+ *
+ * \since 3.3
+ */
+qint64 Database::currentEpoch()
+{
+    return QDateTime::currentMSecsSinceEpoch() / 1000;
 }
 
 /*!
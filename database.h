@@ -27,6 +27,23 @@
 #include <QtDebug>
 #include <QtGlobal>
 #include "configmanager.h"
+#include "startupprofile.h"
+#include "dbmigrator.h"
+#include "databasepersister.h"
+#include "querycache.h"
+#include "searchfilter.h"
+#include "transfergraph.h"
+#include "trigramindex.h"
+#include "fuzzymatcher.h"
+
+// Size of the memory map for read-only snapshots (256 MiB)
+#define snapshot_mmap_size 268435456
+// Longest time in ms to wait for a lock held by another instance
+#define busy_max_wait 10000
+// Shortest time in ms of a writing statement that is taken for a wait for a lock, if the driver waits for the locks
+#define lock_wait_threshold 50
+// Export target under which the time of the last changeset export is stored
+#define changeset_target "changeset"
 
 class Database
 {
@@ -38,25 +55,94 @@ public:
     bool closeDatabase();
 
     QString getDBFilePath();
+    QString getSnapshotUri();
+
+    static QString displayTable(const QString &table);
 
-    QSqlQuery executeQuery(const QString &table, const QStringList &addcols = QStringList(), const QStringList &addvals = QStringList(), const QString &selectcols = "*", const QStringList &connectrelation = QStringList());
+    QSqlQuery executeQuery(const QString &table, const SearchFilter &filter = SearchFilter(), const QString &selectcols = "*");
+
+    CompactTable fetchTable(const QString &table, const SearchFilter &filter = SearchFilter(), const QString &selectcols = "*");
+    bool isCached(const QString &table, const SearchFilter &filter, const QString &selectcols);
+    void cacheRecords(const QString &table, const SearchFilter &filter, const QString &selectcols,
+                      int version, const QSqlRecord &header, const QVector<QSqlRecord> &records);
 
     int deleteEntry(const QString &table, const QString &id);
 
-    int updateEntry(const QString &table, const QStringList &updcols, const QStringList &updvals, const QString &id);
+    int updateEntry(const QString &table, const QStringList &columns, const QStringList &values, const QString &id);
+
+    int insertEntry(const QString &table, const QStringList &columns, const QStringList &values);
 
-    int insertEntry(const QString &table, const QStringList &updcols, const QStringList &updvals);
+    int insertEntries(const QString &table, const QStringList &updcols, const QVector<QStringList> &rows);
 
     int countEntries(const QString &table, const QStringList &addcols = QStringList(), const QStringList &addvals = QStringList());
 
+    QSqlQuery lookupEntries(const QString &table, const QString &column, const QString &prefix, const QString &selectcols, int limit, int offset = 0);
+
+    QList<QSqlRecord> findEntriesByName(const QString &table, const QString &column, const QStringList &names, const QString &selectcols);
+
+    QSet<QPair<QString, QString> > findTransfers(const QList<QPair<QString, QString> > &pairs);
+    QList<QSqlRecord> findEctsDeviations(const QList<QPair<QString, QString> > &pairs);
+
+    QVector<QStringList> sampleLongestValues(const QString &table, const QStringList &columns, int limit);
 
-    static void exec(QSqlQuery *query, const QString &errorText);
+    qint64 exportWatermark(const QString &target);
+    bool setExportWatermark(const QString &target, qint64 time);
+
+    const TransferGraph &getTransferGraph();
+    const TrigramIndex &getNameIndex(const QString &table);
+    const FuzzyMatcher &getFuzzyMatcher(const QString &table);
+
+    int dataVersion() const;
+    bool hasExternalChanges(QStringList *tables = nullptr);
+    bool canChangeExternally() const;
+
+    bool isInMemory() const;
+    bool isReadOnly() const;
+    DatabasePersister *getPersister() const;
+    bool flush();
+
+    void contentChanged();
+
+    static bool exec(QSqlQuery *query, const QString &errorText);
+    static QString getTimestamp();
+    static qint64 currentEpoch();
 private:
     QSqlDatabase SqliteDatabase;
+    int changeCounter;
+    DatabasePersister *persister;
+    bool readOnly;
+    int externalVersion;
+    qint64 externalChangeId;
+    QueryCache queryCache;
+    TransferGraph transferGraph;
+    int graphVersion;
+    QHash<QString, TrigramIndex> nameIndexes;
+    QHash<QString, int> nameIndexVersions;
+    QHash<QString, FuzzyMatcher> fuzzyMatchers;
+    QHash<QString, int> fuzzyMatcherVersions;
+
+    // Waiting for locks held by other instances
+    struct LockWait {
+        QElapsedTimer timer;
+        // Whether the waits are estimated from the duration of the statements, as the driver waits itself
+        bool timed;
+        bool waiting;
+        qint64 current;
+        int count;
+        qint64 total;
+        qint64 longest;
+    };
+    static LockWait lockWait;
+    static int busyHandler(void *data, int count);
+    static void finishLockWait();
+    static void timeLockWait(const QElapsedTimer &timer, bool read, const QSqlError &error);
+    int getSchemaVersion();
+    void resolveLookups(const QString &table, QStringList &cols, QStringList &vals);
+    QString lookupId(const QString &lookupTable, const QString &name);
     bool initDatabase();
-    bool TimestampAdditionMigration();
-    bool columnNotExistsForTable(const QString &table, const QString &column);
-    QString getTimestamp();
+    bool addToTransferGraph(const QVariant &id, const QStringList &cols, const QStringList &vals);
+    void addToNameIndexes(const QString &table, int previousVersion, const QStringList &cols,
+                          const QVector<QVariant> &ids, const QVector<QStringList> &rows);
 };
 
 #endif // DATABASE_H
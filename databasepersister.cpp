@@ -0,0 +1,564 @@
+/*
+ * databasepersister.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "databasepersister.h"
+
+/*!
+ * \class DatabasePersister
+ *
+ * \brief Writes an in-memory working copy of the database back to its file
+ *
+ * In the in-memory mode the database file is loaded into an in-memory database once on opening (see \l load()),
+ * so that all queries are answered from memory. The in-memory database is named by \l workingCopyName(),
+ * so that further connections of the application can attach it.
+ *
+ * Once the working copy has been changed, it is written after a short delay, so that
+ * several changes in a row are written at once. It is written in one of two ways:
+ * \list
+ * \li With the online backup API of SQLite, if the application is built with \c NATIVE_SQLITE and the Qt driver
+ *     uses the very same library, see \l isNativeAvailable(). The pages are then copied in small steps,
+ *     between which control returns to the event loop, so the application stays responsive.
+ *     Changes made during a running backup are carried over to the file by SQLite itself.
+ *     This is the supported way of the in-memory mode.
+ * \li Through the Qt driver as a fallback for all other builds: A connection of its own to the file attaches
+ *     the working copy and replaces all tables, indexes, views and triggers of the file by those of the working copy
+ *     within a single transaction. So each save rewrites the whole file, however small the change was,
+ *     and blocks the application and other instances for as long as that takes.
+ * \endlist
+ *
+ * Which way is used is told by \l isNative(), the status bar shows it in its tool tip.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the DatabasePersister
+ *
+ * The in-memory database \a database is written to the file at \a filePath.
+ * \a parent is passed to the QObject constructor.
+ */
+DatabasePersister::DatabasePersister(QSqlDatabase database, const QString &filePath, QObject *parent) :
+    QObject(parent),
+    db(database),
+    filePath(filePath),
+    native(isNativeAvailable(database)),
+    connectionName(QString("persister-%1").arg(reinterpret_cast<quintptr>(this))),
+#ifdef NATIVE_SQLITE
+    target(nullptr),
+    backup(nullptr),
+#endif
+    lag(0),
+    dirtyAgain(false)
+{
+    delayTimer = new QTimer(this);
+    delayTimer->setSingleShot(true);
+    delayTimer->setInterval(2000);
+    connect(delayTimer, SIGNAL(timeout()), this, SLOT(startBackup()));
+
+    stepTimer = new QTimer(this);
+    stepTimer->setInterval(0);
+    connect(stepTimer, SIGNAL(timeout()), this, SLOT(backupStep()));
+}
+
+/*!
+ * \brief Destroys the DatabasePersister
+ *
+ * A running backup is aborted, pending changes are not written. Use \l flush() before.
+ */
+DatabasePersister::~DatabasePersister()
+{
+#ifdef NATIVE_SQLITE
+    if(backup) {
+        sqlite3_backup_finish(backup);
+    }
+    if(target) {
+        sqlite3_close(target);
+    }
+#endif
+    if(QSqlDatabase::contains(connectionName)) {
+        {
+            QSqlDatabase connection = QSqlDatabase::database(connectionName, false);
+            connection.close();
+        }
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+}
+
+/*!
+ * \brief Returns \c true if the working copy is written with the online backup API
+ *
+ * Otherwise it is written through the Qt driver, which rewrites the whole file on each save.
+ */
+bool DatabasePersister::isNative() const
+{
+    return native;
+}
+
+/*!
+ * \brief Returns the name of the in-memory database of the working copy
+ *
+ * This is a URI of a named in-memory database with a shared cache, which needs to be opened with the option \c QSQLITE_OPEN_URI.
+ * It lives as long as any connection to it is open.
+ */
+QString DatabasePersister::workingCopyName()
+{
+    return QString("file:anerkennungsdb-%1?mode=memory&cache=shared").arg(QCoreApplication::applicationPid());
+}
+
+/*!
+ * \brief Returns whether the native SQLite API can be used on the connection \a database
+ *
+ * This requires the application to be built with \c NATIVE_SQLITE (qmake \c CONFIG+=system_sqlite)
+ * and the Qt driver to use the same SQLite library, which the application is linked against.
+ * Official builds of Qt bundle a library of their own, so the source ID reported by the driver is compared
+ * with the one of the linked library. Otherwise everything is done through the Qt driver.
+ */
+bool DatabasePersister::isNativeAvailable(QSqlDatabase database)
+{
+#ifdef NATIVE_SQLITE
+    if(!handle(database)) {
+        return false;
+    }
+    QSqlQuery query(database);
+    if(!query.exec("SELECT sqlite_source_id()") || !query.next()) {
+        return false;
+    }
+    return query.value(0).toString() == QString::fromLatin1(sqlite3_sourceid());
+#else
+    Q_UNUSED(database)
+    return false;
+#endif
+}
+
+#ifdef NATIVE_SQLITE
+/*!
+ * \brief Returns the SQLite handle of the connection \a database
+ *
+ * A null pointer is returned if the connection does not use the SQLite driver or is not open.
+ * The handle may only be passed to the native API if \l isNativeAvailable() is \c true.
+ */
+sqlite3 *DatabasePersister::handle(QSqlDatabase database)
+{
+    QVariant v = database.driver()->handle();
+    if(v.isValid() && qstrcmp(v.typeName(), "sqlite3*") == 0) {
+        return *static_cast<sqlite3 **>(v.data());
+    }
+    return nullptr;
+}
+#endif
+
+/*!
+ * \brief Loads the database file at \a filePath into the open in-memory database \a database
+ *
+ * The database needs to be opened by the name \l workingCopyName().
+ * A file which does not exist yet leaves the database empty.
+ * Returns \c true on success, otherwise \c false.
+ */
+bool DatabasePersister::load(QSqlDatabase database, const QString &filePath)
+{
+    if(!QFile::exists(filePath)) {
+        return true;
+    }
+
+#ifdef NATIVE_SQLITE
+    if(isNativeAvailable(database)) {
+        sqlite3 *memory = handle(database);
+        sqlite3 *source = nullptr;
+        int rc = sqlite3_open_v2(filePath.toUtf8().constData(), &source, SQLITE_OPEN_READONLY, nullptr);
+        if(rc == SQLITE_OK) {
+            sqlite3_backup *load = sqlite3_backup_init(memory, "main", source, "main");
+            if(load) {
+                rc = sqlite3_backup_step(load, -1);
+                sqlite3_backup_finish(load);
+            } else {
+                rc = sqlite3_errcode(memory);
+            }
+        }
+        if(rc != SQLITE_DONE) {
+            qCritical() << QObject::tr("Error loading the database into memory:") << sqlite3_errstr(rc);
+        }
+        sqlite3_close(source);
+        return rc == SQLITE_DONE;
+    }
+#endif
+
+    // a connection of its own to the working copy, which attaches the file
+    const QString name("persister-load");
+    bool success = false;
+    {
+        QSqlDatabase connection = QSqlDatabase::addDatabase("QSQLITE", name);
+        connection.setConnectOptions("QSQLITE_OPEN_URI");
+        connection.setDatabaseName(database.databaseName());
+        if(connection.open()) {
+            QSqlQuery query(connection);
+            query.prepare("ATTACH DATABASE ? AS Datei");
+            query.bindValue(0, filePath);
+            if(query.exec() && connection.transaction()) {
+                success = copyDatabase(connection, "Datei") && connection.commit();
+                if(!success) {
+                    connection.rollback();
+                }
+            }
+            if(!success) {
+                qCritical() << QObject::tr("Error loading the database into memory:") << query.lastError().text();
+            }
+            query.exec("DETACH DATABASE Datei");
+        }
+        connection.close();
+    }
+    QSqlDatabase::removeDatabase(name);
+    return success;
+}
+
+/*!
+ * \brief Marks the working copy as changed
+ *
+ * The writing is (re)scheduled. If a backup is running, the working copy stays marked as changed after it,
+ * so that it is written again.
+ */
+void DatabasePersister::markDirty()
+{
+    if(!dirtyTime.isValid()) {
+        dirtyTime = QDateTime::currentDateTime();
+    }
+    if(isRunning()) {
+        dirtyAgain = true;
+    } else {
+        delayTimer->start();
+    }
+    emit stateChanged();
+}
+
+/*!
+ * \brief Returns whether a backup with the native API is running
+ */
+bool DatabasePersister::isRunning() const
+{
+#ifdef NATIVE_SQLITE
+    return backup != nullptr;
+#else
+    return false;
+#endif
+}
+
+/*!
+ * \brief Opens the connection to the database file, if not open yet
+ *
+ * The connection of the Qt driver attaches the working copy as \tt Arbeitskopie.
+ */
+bool DatabasePersister::openTarget()
+{
+#ifdef NATIVE_SQLITE
+    if(native) {
+        if(target) {
+            return true;
+        }
+        int rc = sqlite3_open_v2(filePath.toUtf8().constData(), &target, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+        if(rc != SQLITE_OK) {
+            qCritical() << QObject::tr("Error opening the database file for writing:") << sqlite3_errstr(rc);
+            sqlite3_close(target);
+            target = nullptr;
+            return false;
+        }
+        sqlite3_busy_timeout(target, 5000);
+        return true;
+    }
+#endif
+
+    QSqlDatabase connection = QSqlDatabase::contains(connectionName) ? QSqlDatabase::database(connectionName, false)
+                                                                     : QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    if(connection.isOpen()) {
+        return true;
+    }
+    connection.setConnectOptions("QSQLITE_OPEN_URI;QSQLITE_BUSY_TIMEOUT=5000");
+    connection.setDatabaseName(filePath);
+    if(!connection.open()) {
+        qCritical() << QObject::tr("Error opening the database file for writing:") << connection.lastError().text();
+        return false;
+    }
+    QSqlQuery query(connection);
+    query.prepare("ATTACH DATABASE ? AS Arbeitskopie");
+    query.bindValue(0, db.databaseName());
+    if(!query.exec()) {
+        qCritical() << QObject::tr("Error opening the database file for writing:") << query.lastError().text();
+        connection.close();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Writes the working copy into the file
+ *
+ * Through the Qt driver the whole working copy is written at once. With the native API the backup is started,
+ * which is continued by backupStep().
+ */
+void DatabasePersister::startBackup()
+{
+    if(isRunning() || !dirtyTime.isValid()) {
+        return;
+    }
+    if(!native) {
+        finishBackup(writeThroughDriver());
+        return;
+    }
+
+#ifdef NATIVE_SQLITE
+    sqlite3 *memory = handle(db);
+    if(!memory || !openTarget()) {
+        return;
+    }
+    backup = sqlite3_backup_init(target, "main", memory, "main");
+    if(!backup) {
+        qCritical() << QObject::tr("Error starting the backup of the database:") << sqlite3_errmsg(target);
+        return;
+    }
+    dirtyAgain = false;
+    stepTimer->start();
+#endif
+}
+
+/*!
+ * \brief Copies the next pages of the working copy into the file
+ *
+ * If the file is locked by another process, the step is retried on the next call.
+ */
+void DatabasePersister::backupStep()
+{
+#ifdef NATIVE_SQLITE
+    if(!backup) {
+        stepTimer->stop();
+        return;
+    }
+    int rc = sqlite3_backup_step(backup, 64);
+    if(rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+        return;
+    }
+    finishBackup(rc == SQLITE_DONE);
+#else
+    stepTimer->stop();
+#endif
+}
+
+/*!
+ * \brief Replaces the contents of the file by those of the working copy through the Qt driver
+ *
+ * Returns \c true if the transaction was committed.
+ */
+bool DatabasePersister::writeThroughDriver()
+{
+    if(!openTarget()) {
+        return false;
+    }
+    QSqlDatabase connection = QSqlDatabase::database(connectionName, false);
+    if(!connection.transaction()) {
+        return false;
+    }
+    if(copyDatabase(connection, "Arbeitskopie") && connection.commit()) {
+        return true;
+    }
+    connection.rollback();
+    return false;
+}
+
+/*!
+ * \brief Ends the writing of the working copy, which was successful according to \a success
+ */
+void DatabasePersister::finishBackup(bool success)
+{
+    stepTimer->stop();
+#ifdef NATIVE_SQLITE
+    if(backup) {
+        int rc = sqlite3_backup_finish(backup);
+        backup = nullptr;
+        if(rc != SQLITE_OK) {
+            qCritical() << QObject::tr("Error finishing the backup of the database:") << sqlite3_errstr(rc);
+            success = false;
+        }
+    }
+#endif
+
+    if(success) {
+        flushTime = QDateTime::currentDateTime();
+        lag = dirtyTime.msecsTo(flushTime);
+        if(dirtyAgain) {
+            dirtyTime = flushTime;
+            delayTimer->start();
+        } else {
+            dirtyTime = QDateTime();
+        }
+    } else {
+        qCritical() << QObject::tr("Error writing the database file");
+        delayTimer->start();
+    }
+    dirtyAgain = false;
+    emit stateChanged();
+}
+
+/*!
+ * \brief Writes all changes of the working copy into the file at once
+ *
+ * A running backup is completed. This is needed before the database is closed
+ * or the file is accessed directly.
+ * Returns \c true if the file is up to date afterwards.
+ */
+bool DatabasePersister::flush()
+{
+    delayTimer->stop();
+    if(!isRunning()) {
+        if(!dirtyTime.isValid()) {
+            return true;
+        }
+        // the Qt driver writes at once, the native API only starts the backup
+        startBackup();
+        if(!isRunning()) {
+            return !dirtyTime.isValid();
+        }
+    }
+
+#ifdef NATIVE_SQLITE
+    stepTimer->stop();
+    int rc = sqlite3_backup_step(backup, -1);
+    for(int retries = 0; (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) && retries < 50; retries++) {
+        sqlite3_sleep(100);
+        rc = sqlite3_backup_step(backup, -1);
+    }
+    finishBackup(rc == SQLITE_DONE);
+#endif
+    return !dirtyTime.isValid();
+}
+
+/*!
+ * \brief Replaces the contents of the main database of \a connection by those of the attached database \a source
+ *
+ * All tables and views of the main database are dropped (together with their indexes and triggers).
+ * Then the tables of \a source are created and filled, before their indexes, the views and the triggers are created,
+ * so that no trigger fires while copying. The counters of \c AUTOINCREMENT and the schema version are copied as well.
+ * Foreign keys are not enforced, as they are not enabled on the connections of the persister.
+ *
+ * This needs to run within a transaction of \a connection. Returns \c true on success.
+ */
+bool DatabasePersister::copyDatabase(QSqlDatabase connection, const QString &source)
+{
+    QSqlQuery query(connection);
+    QStringList statements;
+    if(!execute(query, "SELECT type, name FROM main.sqlite_master WHERE type IN ('table', 'view') "
+                       "AND name NOT LIKE 'sqlite!_%' ESCAPE '!' ORDER BY type = 'table'")) {
+        return false;
+    }
+    while(query.next()) {
+        statements << QString("DROP %1 IF EXISTS main.\"%2\"").arg(query.value(0).toString().toUpper()).arg(query.value(1).toString());
+    }
+
+    if(!execute(query, QString("SELECT type, name, sql FROM %1.sqlite_master WHERE sql IS NOT NULL "
+                               "AND name NOT LIKE 'sqlite!_%' ESCAPE '!' ORDER BY rowid").arg(source))) {
+        return false;
+    }
+    QStringList inserts, indexes, views, triggers;
+    while(query.next()) {
+        QString type = query.value(0).toString();
+        QString sql = query.value(2).toString();
+        if(type == "table") {
+            statements << sql;
+            inserts << QString("INSERT INTO main.\"%1\" SELECT * FROM %2.\"%1\"").arg(query.value(1).toString()).arg(source);
+        } else if(type == "index") {
+            indexes << sql;
+        } else if(type == "view") {
+            views << sql;
+        } else {
+            triggers << sql;
+        }
+    }
+    statements << inserts;
+
+    if(!execute(query, QString("SELECT COUNT(*) FROM %1.sqlite_master WHERE name = 'sqlite_sequence'").arg(source))
+            || !query.next()) {
+        return false;
+    }
+    if(query.value(0).toInt() > 0) {
+        statements << "DELETE FROM main.sqlite_sequence"
+                   << QString("INSERT INTO main.sqlite_sequence SELECT * FROM %1.sqlite_sequence").arg(source);
+    }
+    statements << indexes << views << triggers;
+
+    if(!execute(query, QString("PRAGMA %1.user_version").arg(source)) || !query.next()) {
+        return false;
+    }
+    statements << QString("PRAGMA main.user_version = %1").arg(query.value(0).toInt());
+
+    for(int i = 0; i < statements.size(); i++) {
+        if(!execute(query, statements.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Executes \a sql with \a query and logs an error
+ *
+ * Returns \c true on success.
+ */
+bool DatabasePersister::execute(QSqlQuery &query, const QString &sql)
+{
+    if(!query.exec(sql)) {
+        qCritical() << QObject::tr("Database error in '%1': %2").arg("DatabasePersister").arg(query.lastError().text());
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Returns whether the working copy contains changes not yet written to the file
+ */
+bool DatabasePersister::isDirty() const
+{
+    return dirtyTime.isValid();
+}
+
+/*!
+ * \brief Returns the time of the first change not yet written to the file
+ *
+ * The returned QDateTime is invalid if all changes are written.
+ */
+QDateTime DatabasePersister::dirtySince() const
+{
+    return dirtyTime;
+}
+
+/*!
+ * \brief Returns the time the last writing of the working copy completed
+ *
+ * The returned QDateTime is invalid if the working copy has not been written yet.
+ */
+QDateTime DatabasePersister::lastFlush() const
+{
+    return flushTime;
+}
+
+/*!
+ * \brief Returns the time in milliseconds between a change and its writing to the file during the last writing
+ */
+qint64 DatabasePersister::lastLag() const
+{
+    return lag;
+}
@@ -0,0 +1,96 @@
+/*
+ * databasepersister.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DATABASEPERSISTER_H
+#define DATABASEPERSISTER_H
+
+#include <QObject>
+#include <QtSql>
+#include <QtDebug>
+#include <QTimer>
+#include <QDateTime>
+#include <QFile>
+#include <QCoreApplication>
+#ifdef NATIVE_SQLITE
+#include <sqlite3.h>
+#endif
+
+class DatabasePersister : public QObject
+{
+    Q_OBJECT
+
+public:
+    DatabasePersister(QSqlDatabase database, const QString &filePath, QObject *parent = nullptr);
+    ~DatabasePersister() Q_DECL_OVERRIDE;
+
+    static QString workingCopyName();
+    static bool load(QSqlDatabase database, const QString &filePath);
+    static bool isNativeAvailable(QSqlDatabase database);
+#ifdef NATIVE_SQLITE
+    static sqlite3 *handle(QSqlDatabase database);
+#endif
+
+    void markDirty();
+    bool flush();
+
+    bool isNative() const;
+    bool isDirty() const;
+    QDateTime dirtySince() const;
+    QDateTime lastFlush() const;
+    qint64 lastLag() const;
+
+signals:
+    void stateChanged();
+
+private slots:
+    void startBackup();
+    void backupStep();
+
+private:
+    QSqlDatabase db;
+    QString filePath;
+    // Whether the online backup API of the native library is used instead of copying through the Qt driver
+    bool native;
+    QString connectionName;
+
+#ifdef NATIVE_SQLITE
+    sqlite3 *target;
+    sqlite3_backup *backup;
+#endif
+    QTimer *delayTimer;
+    QTimer *stepTimer;
+
+    QDateTime dirtyTime;
+    QDateTime flushTime;
+    qint64 lag;
+    bool dirtyAgain;
+
+    bool isRunning() const;
+    bool openTarget();
+    bool writeThroughDriver();
+    void finishBackup(bool success);
+
+    static bool copyDatabase(QSqlDatabase connection, const QString &source);
+    static bool execute(QSqlQuery &query, const QString &sql);
+};
+
+#endif // DATABASEPERSISTER_H
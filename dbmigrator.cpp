@@ -0,0 +1,873 @@
+/*
+ * dbmigrator.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dbmigrator.h"
+#include "database.h"
+
+/*!
+ * \class DBMigrator
+ *
+ * \brief This class performs the migrations of the database scheme
+ *
+ * All migrations are kept in an ordered registry, see \l migrations().
+ * Each of them brings the database to a specific schema version, which is stored in the user_version pragma.
+ *
+ * Every migration runs in a transaction of its own. It is only committed, if the migration step,
+ * the record in the table \tt DBMigration, the update of the schema version and the check of the foreign keys succeed.
+ * Otherwise it is rolled back and no further migrations are performed.
+ *
+ * Long lasting updates of all entries of a table are performed in chunks by \l backfill(),
+ * which reports its progress in a dialog.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the DBMigrator for the database connection \a database
+ */
+DBMigrator::DBMigrator(QSqlDatabase database) : db(database), progress(nullptr)
+{}
+
+/*!
+ * \brief Destroys the DBMigrator
+ *
+ * It also makes sure that the progress dialog is destroyed.
+ */
+DBMigrator::~DBMigrator()
+{
+    delete progress;
+}
+
+/*!
+ * \brief Returns the registry of all migrations
+ *
+ * The migrations are ordered by the schema version they lead to.
+ * New migrations must only be appended with a higher version.
+ *
+ * The names are the ones stored in the table \tt DBMigration.
+ * Migrations performed by version 3.2 or earlier are only recorded there by name.
+ */
+const QVector<DBMigrator::Migration> &DBMigrator::migrations()
+{
+    static const QVector<Migration> registry = QVector<Migration>()
+            << Migration{1, "timestapAddition", &DBMigrator::timestampAddition}
+            << Migration{2, "nameIndexes", &DBMigrator::nameIndexes}
+            << Migration{3, "transferIndexes", &DBMigrator::transferIndexes}
+            << Migration{4, "ectsSummary", &DBMigrator::ectsSummary}
+            << Migration{5, "entryCounters", &DBMigrator::entryCounters}
+            << Migration{6, "lookupTables", &DBMigrator::lookupTables}
+            << Migration{7, "epochTimestamps", &DBMigrator::epochTimestamps}
+            << Migration{8, "deletionLog", &DBMigrator::deletionLog}
+            << Migration{9, "changeLog", &DBMigrator::changeLog};
+    return registry;
+}
+
+/*!
+ * \brief Returns the schema version the database has after all migrations
+ */
+int DBMigrator::latestVersion()
+{
+    return migrations().last().version;
+}
+
+/*!
+ * \brief Returns the error of the last failed migration
+ */
+QString DBMigrator::lastError() const
+{
+    return error;
+}
+
+/*!
+ * \brief Performs all migrations to versions higher than \a fromVersion
+ *
+ * The foreign keys are not enforced during the migrations, as the pragma cannot be changed within a transaction.
+ * Instead they are checked at the end of each migration.
+ *
+ * Returns \c true if all migrations succeeded, otherwise \c false.
+ */
+bool DBMigrator::migrate(int fromVersion)
+{
+    execute("PRAGMA foreign_keys = OFF", "migrate");
+
+    bool success = true;
+    const QVector<Migration> &registry = migrations();
+    for(int i = 0; i < registry.size() && success; i++) {
+        if(registry.at(i).version > fromVersion) {
+            success = runMigration(registry.at(i));
+        }
+    }
+
+    execute("PRAGMA foreign_keys = ON", "migrate");
+    return success;
+}
+
+/*!
+ * \brief Performs the single migration \a migration within a transaction
+ *
+ * If the migration has already been recorded by name, only the schema version is updated.
+ *
+ * Returns \c true if the migration has been committed, otherwise \c false.
+ */
+bool DBMigrator::runMigration(const Migration &migration)
+{
+    qDebug() << QObject::tr("Migrating database to version %1 ('%2')").arg(migration.version).arg(migration.name);
+
+    if(!db.transaction()) {
+        error = db.lastError().text();
+        return false;
+    }
+
+    bool success = true;
+    if(!isRecorded(migration.name)) {
+        success = (this->*migration.step)();
+        if(success) {
+            QSqlQuery query(db);
+            query.prepare("INSERT INTO DBMigration (Name,Datum) VALUES (?,?)");
+            query.bindValue(0, migration.name);
+            query.bindValue(1, Database::getTimestamp());
+            success = exec(&query, "recordMigration");
+        }
+    }
+    if(success) {
+        success = execute(QString("PRAGMA user_version = %1").arg(migration.version), "setSchemaVersion");
+    }
+    if(success) {
+        QSqlQuery query(db);
+        query.prepare("PRAGMA foreign_key_check");
+        success = exec(&query, "foreignKeyCheck");
+        if(success && query.next()) {
+            error = QObject::tr("Foreign key violation in table '%1'").arg(query.value(0).toString());
+            success = false;
+        }
+    }
+
+    if(success && db.commit()) {
+        return true;
+    }
+
+    if(error.isEmpty()) {
+        error = db.lastError().text();
+    }
+    db.rollback();
+    qCritical() << QObject::tr("Database migration '%1' failed and was rolled back: %2").arg(migration.name).arg(error);
+    return false;
+}
+
+/*!
+ * \brief Returns \c true if a migration of name \a name is recorded in the table \tt DBMigration
+ */
+bool DBMigrator::isRecorded(const QString &name)
+{
+    QSqlQuery query(db);
+    query.prepare("SELECT COUNT(*) FROM DBMigration WHERE Name=?");
+    query.bindValue(0, name);
+    if(!exec(&query, "isRecorded") || !query.next()) {
+        return false;
+    }
+    return query.value(0).toBool();
+}
+
+/*!
+ * \brief Executes the already prepared \a query
+ *
+ * The query is executed by \l Database::exec(), which logs any error with \a method.
+ * Returns \c true on success, otherwise \c false and the error is kept.
+ */
+bool DBMigrator::exec(QSqlQuery *query, const QString &method)
+{
+    if(!Database::exec(query, method)) {
+        error = query->lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Prepares and executes the statement \a sql
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool DBMigrator::execute(const QString &sql, const QString &method)
+{
+    QSqlQuery query(db);
+    query.prepare(sql);
+    return exec(&query, method);
+}
+
+/*!
+ * \brief Updates all entries of a table in chunks
+ *
+ * The entries of table \a table are updated according to \a assignments, which are given
+ * in a manner that is understood by a SQL UPDATE command after \c SET.
+ *
+ * The entries are processed in the order of their ID in chunks of \a chunkSize entries.
+ * After each chunk the progress dialog, labelled by \a label, is updated and pending events are processed.
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool DBMigrator::backfill(const QString &table, const QString &assignments, const QString &label, int chunkSize)
+{
+    QSqlQuery query(db);
+    query.prepare(QString("SELECT COUNT(*) FROM %1").arg(table));
+    if(!exec(&query, "backfillCount") || !query.next()) {
+        return false;
+    }
+    int total = query.value(0).toInt();
+    query.finish();
+
+    if(!progress) {
+        progress = new QProgressDialog();
+        progress->setWindowTitle(QObject::tr("Database migration"));
+        progress->setCancelButton(nullptr);
+        progress->setWindowModality(Qt::ApplicationModal);
+        progress->setMinimumDuration(500);
+    }
+    progress->setLabelText(label);
+    progress->setRange(0, total);
+    progress->setValue(0);
+
+    QSqlQuery chunk(db);
+    chunk.prepare(QString("SELECT MAX(ID), COUNT(*) FROM (SELECT ID FROM %1 WHERE ID > ? ORDER BY ID LIMIT ?)").arg(table));
+    QSqlQuery update(db);
+    update.prepare(QString("UPDATE %1 SET %2 WHERE ID > ? AND ID <= ?").arg(table).arg(assignments));
+
+    qlonglong lastId = std::numeric_limits<qlonglong>::min();
+    int done = 0;
+    while(done < total) {
+        chunk.bindValue(0, lastId);
+        chunk.bindValue(1, chunkSize);
+        if(!exec(&chunk, "backfillChunk") || !chunk.next()) {
+            return false;
+        }
+        int count = chunk.value(1).toInt();
+        qlonglong maxId = chunk.value(0).toLongLong();
+        chunk.finish();
+        if(count == 0) break;
+
+        update.bindValue(0, lastId);
+        update.bindValue(1, maxId);
+        if(!exec(&update, "backfillUpdate")) {
+            return false;
+        }
+
+        lastId = maxId;
+        done += count;
+        progress->setValue(done);
+        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+    }
+    progress->setValue(total);
+    return true;
+}
+
+/*!
+ * \brief This function checks for the non existence of columns in a table
+ *
+ * It queries the table structure of \a table if the \a column exists.
+ * This function returns a \c bool which is false if the column does not exists.
+ */
+bool DBMigrator::columnNotExistsForTable(const QString &table, const QString &column)
+{
+    QSqlQuery query(db);
+    query.prepare(QString("PRAGMA table_info(%1)").arg(table));
+    exec(&query, "columnExists");
+    while (query.next()) {
+        if(column.compare(query.value(1).toString(), Qt::CaseInsensitive) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Timestamp database migration
+ *
+ * This function performs the database migration of adding a column 'Datum'
+ * containing the timestamp of modification to all tables.
+ *
+ * The views are recreated if necessary
+ *
+ * If any modification is actually performed, the settings of the tableview column widths are also removed.
+ * (otherwise it would lead to columns being visible).
+ */
+bool DBMigrator::timestampAddition()
+{
+    bool refreshviews = false;
+
+    QString sqlstring("ALTER TABLE %1 ADD COLUMN Datum Text NOT NULL DEFAULT '%2'");
+    QStringList tables;
+    tables << "Module" << "Kurse" << "Anerkennungen";
+    for(int i = 0; i < tables.size(); i++) {
+        if(columnNotExistsForTable(tables.at(i), "Datum")) {
+            if(!execute(sqlstring.arg(tables.at(i)).arg(Database::getTimestamp()), QString("ALTER TABLE %1 (Timestamp)").arg(tables.at(i)))) {
+                return false;
+            }
+            refreshviews = true;
+        }
+    }
+
+    if(refreshviews){
+        // Recreate Views
+        //anerkmodule
+        bool success = execute("DROP VIEW IF EXISTS anerkmodule", "DROP VIEW anerkmodule (Timestamp)")
+                && execute("CREATE VIEW anerkmodule AS "
+                           "SELECT A.MID AS ID, K.Kursname AS Kursname, K.ECTS AS ECTS, K.Herkunft AS Herkunft, K.Datum AS Datum "
+                           "FROM Anerkennungen A JOIN Kurse K ON K.ID = A.KID", "CREATE VIEW anerkmodule (Timestamp)")
+        // anerkkurse
+                && execute("DROP VIEW IF EXISTS anerkkurse", "DROP VIEW anerkkurse (Timestamp)")
+                && execute("CREATE VIEW anerkkurse AS "
+                           "SELECT A.KID AS ID, M.Modulname AS Modulname, M.ECTS AS ECTS, M.PO AS PO, M.Datum AS Datum "
+                           "FROM Module M JOIN Anerkennungen A ON A.MID=M.ID", "CREATE VIEW anerkkurse (Timestamp)");
+        if(!success) {
+            return false;
+        }
+
+        // As we have updated some table scheme, we need to remove all the settings of the tableView to avoid inconsistencies
+        ConfigManager::getInstance()->removeGroupSettings("tableViewWidths");
+    }
+    return true;
+}
+
+/*!
+ * \brief Name index database migration
+ *
+ * This function creates case insensitive indexes on the names of courses and modules.
+ * They allow to look up entries by the beginning of their name without scanning the whole table
+ * (see \l Database::lookupEntries()).
+ */
+bool DBMigrator::nameIndexes()
+{
+    return execute("CREATE INDEX IF NOT EXISTS KurseKursname ON Kurse(Kursname COLLATE NOCASE)", "CREATE INDEX KurseKursname")
+            && execute("CREATE INDEX IF NOT EXISTS ModuleModulname ON Module(Modulname COLLATE NOCASE)", "CREATE INDEX ModuleModulname");
+}
+
+/*!
+ * \brief Transfer index database migration
+ *
+ * This function creates indexes on the course and module IDs of the transfers.
+ * They allow to check many pairs of courses and modules for existing transfers at once
+ * (see \l Database::findTransfers()) and speed up the foreign key checks on deletion.
+ */
+bool DBMigrator::transferIndexes()
+{
+    return execute("CREATE INDEX IF NOT EXISTS AnerkennungenKursModul ON Anerkennungen(KID, MID)", "CREATE INDEX AnerkennungenKursModul")
+            && execute("CREATE INDEX IF NOT EXISTS AnerkennungenModul ON Anerkennungen(MID)", "CREATE INDEX AnerkennungenModul");
+}
+
+/*!
+ * \brief ECTS summary database migration
+ *
+ * This function creates the table \tt ModulECTS, which holds for each module (of same ID)
+ * the number of transfers to it, the sum of the ECTS of the transferred courses
+ * and a flag \tt Abweichung whether this sum deviates from the ECTS of the module.
+ *
+ * The table is filled once and then kept up to date by triggers on all tables,
+ * so that a change in a single entry only touches the affected modules.
+ * The view \tt ectsabweichungen lists all transfers to modules with deviating ECTS,
+ * using the index on the flag.
+ */
+bool DBMigrator::ectsSummary()
+{
+    QString deviation = ectsDeviation();
+
+    bool success = execute("CREATE TABLE IF NOT EXISTS ModulECTS ("
+                             "ID INTEGER NOT NULL PRIMARY KEY REFERENCES Module(ID),"
+                             "Anzahl INTEGER NOT NULL DEFAULT 0,"
+                             "KursECTS INTEGER NOT NULL DEFAULT 0,"
+                             "Abweichung INTEGER NOT NULL DEFAULT 0"
+                           ")", "CREATE TABLE ModulECTS")
+            && execute("INSERT OR IGNORE INTO ModulECTS (ID) SELECT ID FROM Module", "INSERT INTO ModulECTS")
+            && backfill("ModulECTS",
+                        "Anzahl = (SELECT COUNT(*) FROM Anerkennungen A WHERE A.MID = ModulECTS.ID),"
+                        "KursECTS = (SELECT IFNULL(SUM(K.ECTS), 0) FROM Anerkennungen A JOIN Kurse K ON K.ID = A.KID WHERE A.MID = ModulECTS.ID)",
+                        QObject::tr("Summing up the ECTS of the transfers..."))
+            && backfill("ModulECTS", deviation, QObject::tr("Checking the ECTS of the modules..."))
+            && execute("CREATE INDEX IF NOT EXISTS ModulECTSAbweichung ON ModulECTS(Abweichung)", "CREATE INDEX ModulECTSAbweichung");
+    if(!success || !createEctsTriggers()) {
+        return false;
+    }
+
+    // Report view of all transfers to modules with deviating ECTS
+    return execute("DROP VIEW IF EXISTS ectsabweichungen", "DROP VIEW ectsabweichungen")
+            && execute("CREATE VIEW ectsabweichungen AS "
+                       "SELECT A.ID AS ID, M.Modulname AS Modulname, M.PO AS PO, M.ECTS AS ECTS, E.KursECTS AS Summe, "
+                       "K.Kursname AS Kursname, K.Herkunft AS Herkunft, K.ECTS AS KursECTS "
+                       "FROM ModulECTS E JOIN Module M ON M.ID = E.ID JOIN Anerkennungen A ON A.MID = E.ID JOIN Kurse K ON K.ID = A.KID "
+                       "WHERE E.Abweichung = 1", "CREATE VIEW ectsabweichungen");
+}
+
+/*!
+ * \brief Returns the SQL assignment of the ECTS deviation flag of the table \tt ModulECTS
+ */
+QString DBMigrator::ectsDeviation()
+{
+    return "Abweichung = (Anzahl > 0 AND KursECTS <> (SELECT ECTS FROM Module WHERE ID = ModulECTS.ID))";
+}
+
+/*!
+ * \brief Creates the triggers which keep the table \tt ModulECTS up to date
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool DBMigrator::createEctsTriggers()
+{
+    QString deviation = ectsDeviation();
+    QStringList triggers;
+    triggers << "CREATE TRIGGER ModulECTSModulInsert AFTER INSERT ON Module BEGIN "
+                  "INSERT INTO ModulECTS (ID) VALUES (NEW.ID); "
+                "END"
+             << "CREATE TRIGGER ModulECTSModulDelete AFTER DELETE ON Module BEGIN "
+                  "DELETE FROM ModulECTS WHERE ID = OLD.ID; "
+                "END"
+             << "CREATE TRIGGER ModulECTSModulUpdate AFTER UPDATE OF ECTS ON Module BEGIN "
+                  "UPDATE ModulECTS SET Abweichung = (Anzahl > 0 AND KursECTS <> NEW.ECTS) WHERE ID = NEW.ID; "
+                "END"
+             << "CREATE TRIGGER ModulECTSAnerkennungInsert AFTER INSERT ON Anerkennungen BEGIN "
+                  "UPDATE ModulECTS SET Anzahl = Anzahl + 1, KursECTS = KursECTS + IFNULL((SELECT ECTS FROM Kurse WHERE ID = NEW.KID), 0) WHERE ID = NEW.MID; "
+                  "UPDATE ModulECTS SET " + deviation + " WHERE ID = NEW.MID; "
+                "END"
+             << "CREATE TRIGGER ModulECTSAnerkennungDelete AFTER DELETE ON Anerkennungen BEGIN "
+                  "UPDATE ModulECTS SET Anzahl = Anzahl - 1, KursECTS = KursECTS - IFNULL((SELECT ECTS FROM Kurse WHERE ID = OLD.KID), 0) WHERE ID = OLD.MID; "
+                  "UPDATE ModulECTS SET " + deviation + " WHERE ID = OLD.MID; "
+                "END"
+             << "CREATE TRIGGER ModulECTSAnerkennungUpdate AFTER UPDATE OF KID, MID ON Anerkennungen BEGIN "
+                  "UPDATE ModulECTS SET Anzahl = Anzahl - 1, KursECTS = KursECTS - IFNULL((SELECT ECTS FROM Kurse WHERE ID = OLD.KID), 0) WHERE ID = OLD.MID; "
+                  "UPDATE ModulECTS SET Anzahl = Anzahl + 1, KursECTS = KursECTS + IFNULL((SELECT ECTS FROM Kurse WHERE ID = NEW.KID), 0) WHERE ID = NEW.MID; "
+                  "UPDATE ModulECTS SET " + deviation + " WHERE ID IN (OLD.MID, NEW.MID); "
+                "END"
+             << "CREATE TRIGGER ModulECTSKursUpdate AFTER UPDATE OF ECTS ON Kurse BEGIN "
+                  "UPDATE ModulECTS SET KursECTS = KursECTS + (NEW.ECTS - OLD.ECTS) * (SELECT COUNT(*) FROM Anerkennungen WHERE KID = NEW.ID AND MID = ModulECTS.ID) "
+                    "WHERE ID IN (SELECT MID FROM Anerkennungen WHERE KID = NEW.ID); "
+                  "UPDATE ModulECTS SET " + deviation + " WHERE ID IN (SELECT MID FROM Anerkennungen WHERE KID = NEW.ID); "
+                "END";
+    for(int i = 0; i < triggers.size(); i++) {
+        if(!execute(triggers.at(i), "CREATE TRIGGER (ECTS summary)")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Entry counter database migration
+ *
+ * This function creates the table \tt Zaehler, which holds the number of entries of
+ * the tables \tt Kurse, \tt Module and \tt Anerkennungen.
+ * The numbers are counted once and then kept up to date by triggers on insertion and deletion,
+ * so that they can be read without scanning the tables (see \l Database::countEntries()).
+ */
+bool DBMigrator::entryCounters()
+{
+    if(!execute("CREATE TABLE IF NOT EXISTS Zaehler ("
+                  "Tabelle TEXT NOT NULL PRIMARY KEY,"
+                  "Anzahl INTEGER NOT NULL DEFAULT 0"
+                ")", "CREATE TABLE Zaehler")) {
+        return false;
+    }
+
+    QStringList tables;
+    tables << "Kurse" << "Module" << "Anerkennungen";
+    for(int i = 0; i < tables.size(); i++) {
+        QString table = tables.at(i);
+        bool success = execute(QString("INSERT OR REPLACE INTO Zaehler (Tabelle, Anzahl) SELECT '%1', COUNT(*) FROM %1").arg(table), "INSERT INTO Zaehler")
+                && createCounterTriggers(table);
+        if(!success) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Creates the triggers which count the entries of \a table in the table \tt Zaehler
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool DBMigrator::createCounterTriggers(const QString &table)
+{
+    return execute(QString("CREATE TRIGGER Zaehler%1Insert AFTER INSERT ON %1 BEGIN "
+                             "UPDATE Zaehler SET Anzahl = Anzahl + 1 WHERE Tabelle = '%1'; "
+                           "END").arg(table), QString("CREATE TRIGGER Zaehler%1Insert").arg(table))
+            && execute(QString("CREATE TRIGGER Zaehler%1Delete AFTER DELETE ON %1 BEGIN "
+                                 "UPDATE Zaehler SET Anzahl = Anzahl - 1 WHERE Tabelle = '%1'; "
+                               "END").arg(table), QString("CREATE TRIGGER Zaehler%1Delete").arg(table));
+}
+
+/*!
+ * \brief Rebuilds the table \a table with the column definitions \a columns
+ *
+ * The entries are copied into a new table by the SQL select list \a select, which refers to the columns of the old table.
+ * The old table is dropped together with its indexes and triggers and the new table takes its name.
+ * Views and triggers of other tables referring to \a table need to be dropped before.
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool DBMigrator::rebuildTable(const QString &table, const QString &columns, const QString &select)
+{
+    return execute(QString("CREATE TABLE %1Neu (%2)").arg(table).arg(columns), QString("CREATE TABLE %1Neu").arg(table))
+            && execute(QString("INSERT INTO %1Neu SELECT %2 FROM %1").arg(table).arg(select), QString("INSERT INTO %1Neu").arg(table))
+            && execute(QString("DROP TABLE %1").arg(table), QString("DROP TABLE %1").arg(table))
+            && execute(QString("ALTER TABLE %1Neu RENAME TO %1").arg(table), QString("RENAME TABLE %1Neu").arg(table));
+}
+
+/*!
+ * \brief Lookup table database migration
+ *
+ * This function moves the origins of the courses and the POs of the modules, which are repeated on many entries,
+ * into the tables \tt Herkunft and \tt PO. Each distinct name is stored there once and
+ * the courses and modules reference it by the integer columns \tt HID and \tt POID, which are indexed.
+ * So finding e.g. all courses of an origin is an index lookup instead of comparing the names of all entries.
+ *
+ * As SQLite cannot drop columns which are used in views or triggers, the tables \tt Kurse and \tt Module are
+ * rebuilt. All views and triggers depending on them are dropped before and created anew afterwards.
+ * The views \tt kursliste and \tt modulliste show the courses and modules with the names of their origins and POs
+ * in the former columns \tt Herkunft and \tt PO.
+ */
+bool DBMigrator::lookupTables()
+{
+    QStringList lookups;
+    lookups << "Herkunft" << "PO";
+    for(int i = 0; i < lookups.size(); i++) {
+        if(!execute(QString("CREATE TABLE IF NOT EXISTS %1 ("
+                              "ID INTEGER NOT NULL PRIMARY KEY,"
+                              "Name TEXT NOT NULL UNIQUE"
+                            ")").arg(lookups.at(i)), QString("CREATE TABLE %1").arg(lookups.at(i)))) {
+            return false;
+        }
+    }
+    bool success = execute("INSERT OR IGNORE INTO Herkunft (Name) SELECT DISTINCT Herkunft FROM Kurse WHERE IFNULL(Herkunft, '') <> '' ORDER BY Herkunft",
+                           "INSERT INTO Herkunft")
+            && execute("INSERT OR IGNORE INTO PO (Name) SELECT DISTINCT PO FROM Module WHERE IFNULL(PO, '') <> '' ORDER BY PO",
+                       "INSERT INTO PO");
+    if(!success) {
+        return false;
+    }
+
+    // Everything referring to the tables to be rebuilt
+    QStringList views, triggers;
+    views << "anerkmodule" << "anerkkurse" << "ectsabweichungen";
+    triggers << "ModulECTSAnerkennungInsert" << "ModulECTSAnerkennungDelete" << "ModulECTSAnerkennungUpdate";
+    for(int i = 0; i < views.size(); i++) {
+        if(!execute(QString("DROP VIEW IF EXISTS %1").arg(views.at(i)), QString("DROP VIEW %1").arg(views.at(i)))) {
+            return false;
+        }
+    }
+    for(int i = 0; i < triggers.size(); i++) {
+        if(!execute(QString("DROP TRIGGER IF EXISTS %1").arg(triggers.at(i)), QString("DROP TRIGGER %1").arg(triggers.at(i)))) {
+            return false;
+        }
+    }
+
+    // Rebuild the tables, which also drops their indexes and triggers
+    success = execute("CREATE TABLE KurseNeu ("
+                        "ID INTEGER NOT NULL PRIMARY KEY,"
+                        "Kursname TEXT NOT NULL,"
+                        "HID INTEGER REFERENCES Herkunft(ID),"
+                        "ECTS INTEGER NOT NULL,"
+                        "Datum TEXT NOT NULL"
+                      ")", "CREATE TABLE KurseNeu")
+            && execute("INSERT INTO KurseNeu (ID, Kursname, HID, ECTS, Datum) "
+                       "SELECT K.ID, K.Kursname, H.ID, K.ECTS, K.Datum FROM Kurse K LEFT JOIN Herkunft H ON H.Name = K.Herkunft",
+                       "INSERT INTO KurseNeu")
+            && execute("DROP TABLE Kurse", "DROP TABLE Kurse")
+            && execute("ALTER TABLE KurseNeu RENAME TO Kurse", "RENAME TABLE KurseNeu")
+            && execute("CREATE TABLE ModuleNeu ("
+                         "ID INTEGER NOT NULL PRIMARY KEY,"
+                         "Modulname TEXT NOT NULL,"
+                         "POID INTEGER REFERENCES PO(ID),"
+                         "ECTS INTEGER NOT NULL,"
+                         "Datum TEXT NOT NULL"
+                       ")", "CREATE TABLE ModuleNeu")
+            && execute("INSERT INTO ModuleNeu (ID, Modulname, POID, ECTS, Datum) "
+                       "SELECT M.ID, M.Modulname, P.ID, M.ECTS, M.Datum FROM Module M LEFT JOIN PO P ON P.Name = M.PO",
+                       "INSERT INTO ModuleNeu")
+            && execute("DROP TABLE Module", "DROP TABLE Module")
+            && execute("ALTER TABLE ModuleNeu RENAME TO Module", "RENAME TABLE ModuleNeu")
+            && nameIndexes()
+            && execute("CREATE INDEX IF NOT EXISTS KurseHerkunft ON Kurse(HID)", "CREATE INDEX KurseHerkunft")
+            && execute("CREATE INDEX IF NOT EXISTS ModulePO ON Module(POID)", "CREATE INDEX ModulePO")
+            && createEctsTriggers()
+            && createCounterTriggers("Kurse")
+            && createCounterTriggers("Module");
+    if(!success) {
+        return false;
+    }
+
+    // Views with the names of the origins and POs
+    return execute("CREATE VIEW kursliste AS "
+                   "SELECT K.ID AS ID, K.Kursname AS Kursname, H.Name AS Herkunft, K.ECTS AS ECTS, K.Datum AS Datum "
+                   "FROM Kurse K LEFT JOIN Herkunft H ON H.ID = K.HID", "CREATE VIEW kursliste")
+            && execute("CREATE VIEW modulliste AS "
+                       "SELECT M.ID AS ID, M.Modulname AS Modulname, P.Name AS PO, M.ECTS AS ECTS, M.Datum AS Datum "
+                       "FROM Module M LEFT JOIN PO P ON P.ID = M.POID", "CREATE VIEW modulliste")
+            && execute("CREATE VIEW anerkmodule AS "
+                       "SELECT A.MID AS ID, K.Kursname AS Kursname, K.ECTS AS ECTS, H.Name AS Herkunft, K.Datum AS Datum "
+                       "FROM Anerkennungen A JOIN Kurse K ON K.ID = A.KID LEFT JOIN Herkunft H ON H.ID = K.HID", "CREATE VIEW anerkmodule")
+            && execute("CREATE VIEW anerkkurse AS "
+                       "SELECT A.KID AS ID, M.Modulname AS Modulname, M.ECTS AS ECTS, P.Name AS PO, M.Datum AS Datum "
+                       "FROM Module M JOIN Anerkennungen A ON A.MID = M.ID LEFT JOIN PO P ON P.ID = M.POID", "CREATE VIEW anerkkurse")
+            && execute("CREATE VIEW ectsabweichungen AS "
+                       "SELECT A.ID AS ID, M.Modulname AS Modulname, P.Name AS PO, M.ECTS AS ECTS, E.KursECTS AS Summe, "
+                       "K.Kursname AS Kursname, H.Name AS Herkunft, K.ECTS AS KursECTS "
+                       "FROM ModulECTS E JOIN Module M ON M.ID = E.ID JOIN Anerkennungen A ON A.MID = E.ID JOIN Kurse K ON K.ID = A.KID "
+                       "LEFT JOIN Herkunft H ON H.ID = K.HID LEFT JOIN PO P ON P.ID = M.POID "
+                       "WHERE E.Abweichung = 1", "CREATE VIEW ectsabweichungen");
+}
+
+/*!
+ * \brief Epoch timestamp database migration
+ *
+ * This function replaces the text column \tt Datum of the courses, modules and transfers by the integer columns
+ * \tt Zeit, the time of the last modification, and \tt Erstellt, the time of creation, both in seconds since the epoch.
+ * Both are indexed, so restricting the entries to a time range is an index lookup instead of comparing strings.
+ * As the time of creation is not known for existing entries, it is set to the time of their last modification.
+ *
+ * The tables are rebuilt, see \l rebuildTable(). All views and triggers depending on them are dropped before and created anew afterwards.
+ * The views keep showing the time of the last modification as local time in the column \tt Datum.
+ * The new view \tt anerkennungsliste does so for the transfers.
+ */
+bool DBMigrator::epochTimestamps()
+{
+    QStringList views, triggers;
+    views << "kursliste" << "modulliste" << "anerkmodule" << "anerkkurse" << "ectsabweichungen" << "anerkennungsliste";
+    triggers << "ModulECTSModulInsert" << "ModulECTSModulDelete" << "ModulECTSModulUpdate"
+             << "ModulECTSAnerkennungInsert" << "ModulECTSAnerkennungDelete" << "ModulECTSAnerkennungUpdate" << "ModulECTSKursUpdate"
+             << "ZaehlerKurseInsert" << "ZaehlerKurseDelete" << "ZaehlerModuleInsert" << "ZaehlerModuleDelete"
+             << "ZaehlerAnerkennungenInsert" << "ZaehlerAnerkennungenDelete";
+    for(int i = 0; i < views.size(); i++) {
+        if(!execute(QString("DROP VIEW IF EXISTS %1").arg(views.at(i)), QString("DROP VIEW %1").arg(views.at(i)))) {
+            return false;
+        }
+    }
+    for(int i = 0; i < triggers.size(); i++) {
+        if(!execute(QString("DROP TRIGGER IF EXISTS %1").arg(triggers.at(i)), QString("DROP TRIGGER %1").arg(triggers.at(i)))) {
+            return false;
+        }
+    }
+
+    // The stored local time converted to seconds since the epoch, unparsable ones are replaced by the current time
+    QString epoch = "IFNULL(CAST(strftime('%s', Datum, 'utc') AS INTEGER), CAST(strftime('%s', 'now') AS INTEGER))";
+    QString times = QString("%1 AS Zeit, %1 AS Erstellt").arg(epoch);
+
+    bool success = rebuildTable("Kurse",
+                                "ID INTEGER NOT NULL PRIMARY KEY,"
+                                "Kursname TEXT NOT NULL,"
+                                "HID INTEGER REFERENCES Herkunft(ID),"
+                                "ECTS INTEGER NOT NULL,"
+                                "Zeit INTEGER NOT NULL,"
+                                "Erstellt INTEGER NOT NULL",
+                                "ID, Kursname, HID, ECTS, " + times)
+            && rebuildTable("Module",
+                            "ID INTEGER NOT NULL PRIMARY KEY,"
+                            "Modulname TEXT NOT NULL,"
+                            "POID INTEGER REFERENCES PO(ID),"
+                            "ECTS INTEGER NOT NULL,"
+                            "Zeit INTEGER NOT NULL,"
+                            "Erstellt INTEGER NOT NULL",
+                            "ID, Modulname, POID, ECTS, " + times)
+            && rebuildTable("Anerkennungen",
+                            "ID INTEGER NOT NULL PRIMARY KEY,"
+                            "MID INTEGER, KID INTEGER,"
+                            "Zeit INTEGER NOT NULL,"
+                            "Erstellt INTEGER NOT NULL,"
+                            "FOREIGN KEY(MID) REFERENCES Module(ID),"
+                            "FOREIGN KEY(KID) REFERENCES Kurse(ID)",
+                            "ID, MID, KID, " + times)
+            && nameIndexes()
+            && transferIndexes()
+            && execute("CREATE INDEX IF NOT EXISTS KurseHerkunft ON Kurse(HID)", "CREATE INDEX KurseHerkunft")
+            && execute("CREATE INDEX IF NOT EXISTS ModulePO ON Module(POID)", "CREATE INDEX ModulePO")
+            && createEctsTriggers()
+            && createCounterTriggers("Kurse")
+            && createCounterTriggers("Module")
+            && createCounterTriggers("Anerkennungen");
+    if(!success) {
+        return false;
+    }
+
+    QStringList tables;
+    tables << "Kurse" << "Module" << "Anerkennungen";
+    for(int i = 0; i < tables.size(); i++) {
+        QString table = tables.at(i);
+        success = execute(QString("CREATE INDEX IF NOT EXISTS %1Zeit ON %1(Zeit)").arg(table), QString("CREATE INDEX %1Zeit").arg(table))
+                && execute(QString("CREATE INDEX IF NOT EXISTS %1Erstellt ON %1(Erstellt)").arg(table), QString("CREATE INDEX %1Erstellt").arg(table));
+        if(!success) {
+            return false;
+        }
+    }
+
+    // Views showing the time of the last modification as local time
+    return execute("CREATE VIEW kursliste AS "
+                   "SELECT K.ID AS ID, K.Kursname AS Kursname, H.Name AS Herkunft, K.ECTS AS ECTS, "
+                   "datetime(K.Zeit, 'unixepoch', 'localtime') AS Datum "
+                   "FROM Kurse K LEFT JOIN Herkunft H ON H.ID = K.HID", "CREATE VIEW kursliste")
+            && execute("CREATE VIEW modulliste AS "
+                       "SELECT M.ID AS ID, M.Modulname AS Modulname, P.Name AS PO, M.ECTS AS ECTS, "
+                       "datetime(M.Zeit, 'unixepoch', 'localtime') AS Datum "
+                       "FROM Module M LEFT JOIN PO P ON P.ID = M.POID", "CREATE VIEW modulliste")
+            && execute("CREATE VIEW anerkennungsliste AS "
+                       "SELECT ID, MID, KID, datetime(Zeit, 'unixepoch', 'localtime') AS Datum "
+                       "FROM Anerkennungen", "CREATE VIEW anerkennungsliste")
+            && execute("CREATE VIEW anerkmodule AS "
+                       "SELECT A.MID AS ID, K.Kursname AS Kursname, K.ECTS AS ECTS, H.Name AS Herkunft, "
+                       "datetime(K.Zeit, 'unixepoch', 'localtime') AS Datum "
+                       "FROM Anerkennungen A JOIN Kurse K ON K.ID = A.KID LEFT JOIN Herkunft H ON H.ID = K.HID", "CREATE VIEW anerkmodule")
+            && execute("CREATE VIEW anerkkurse AS "
+                       "SELECT A.KID AS ID, M.Modulname AS Modulname, M.ECTS AS ECTS, P.Name AS PO, "
+                       "datetime(M.Zeit, 'unixepoch', 'localtime') AS Datum "
+                       "FROM Module M JOIN Anerkennungen A ON A.MID = M.ID LEFT JOIN PO P ON P.ID = M.POID", "CREATE VIEW anerkkurse")
+            && execute("CREATE VIEW ectsabweichungen AS "
+                       "SELECT A.ID AS ID, M.Modulname AS Modulname, P.Name AS PO, M.ECTS AS ECTS, E.KursECTS AS Summe, "
+                       "K.Kursname AS Kursname, H.Name AS Herkunft, K.ECTS AS KursECTS "
+                       "FROM ModulECTS E JOIN Module M ON M.ID = E.ID JOIN Anerkennungen A ON A.MID = E.ID JOIN Kurse K ON K.ID = A.KID "
+                       "LEFT JOIN Herkunft H ON H.ID = K.HID LEFT JOIN PO P ON P.ID = M.POID "
+                       "WHERE E.Abweichung = 1", "CREATE VIEW ectsabweichungen");
+}
+
+/*!
+ * \brief Deletion log database migration
+ *
+ * This function creates the table \tt Geloescht, in which triggers record each deleted course, module and transfer
+ * by its table, its ID and the time of deletion in seconds since the epoch. The time is indexed,
+ * so the deletions since a given time are found without scanning the whole log.
+ *
+ * The table \tt Exportstand holds for each target of an incremental export the time of the last export,
+ * see \l Database::exportWatermark().
+ */
+bool DBMigrator::deletionLog()
+{
+    bool success = execute("CREATE TABLE IF NOT EXISTS Geloescht ("
+                             "ID INTEGER NOT NULL PRIMARY KEY,"
+                             "Tabelle TEXT NOT NULL,"
+                             "Eintrag INTEGER NOT NULL,"
+                             "Zeit INTEGER NOT NULL"
+                           ")", "CREATE TABLE Geloescht")
+            && execute("CREATE INDEX IF NOT EXISTS GeloeschtZeit ON Geloescht(Zeit)", "CREATE INDEX GeloeschtZeit")
+            && execute("CREATE TABLE IF NOT EXISTS Exportstand ("
+                         "Ziel TEXT NOT NULL PRIMARY KEY,"
+                         "Zeit INTEGER NOT NULL"
+                       ")", "CREATE TABLE Exportstand");
+    if(!success) {
+        return false;
+    }
+
+    QStringList tables;
+    tables << "Kurse" << "Module" << "Anerkennungen";
+    for(int i = 0; i < tables.size(); i++) {
+        if(!createDeletionTriggers(tables.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Creates the trigger which records the deleted entries of \a table in the table \tt Geloescht
+ *
+ * If \a withGuid is \c true, the GUID of the deleted entry is recorded as well.
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool DBMigrator::createDeletionTriggers(const QString &table, bool withGuid)
+{
+    QString columns = withGuid ? "Tabelle, Eintrag, Zeit, GUID" : "Tabelle, Eintrag, Zeit";
+    QString values = withGuid ? "'%1', OLD.ID, %2, OLD.GUID" : "'%1', OLD.ID, %2";
+    return execute(QString("CREATE TRIGGER Geloescht%1Delete AFTER DELETE ON %1 BEGIN "
+                             "INSERT INTO Geloescht (%2) VALUES (%3); "
+                           "END").arg(table).arg(columns).arg(values.arg(table).arg("CAST(strftime('%s', 'now') AS INTEGER)")),
+                   QString("CREATE TRIGGER Geloescht%1Delete").arg(table));
+}
+
+/*!
+ * \brief Change log database migration
+ *
+ * This function gives each course, module and transfer a globally unique identifier in the column \tt GUID,
+ * which identifies it in all copies of the database. New entries get a random one.
+ * The one of an existing entry is derived from its table, its ID and its time of creation,
+ * so copies of the database made before this migration assign the same GUIDs to their common entries.
+ * Entries which were changed in one copy before the time of creation was introduced by \l epochTimestamps()
+ * got their time of last modification as time of creation, so their GUIDs differ between the copies.
+ *
+ * The table \tt Aenderungen records by triggers for every insertion and update the table,
+ * the GUID of the entry and the time of the change in seconds since the epoch, which is indexed.
+ * So the entries changed since a given time are found for the exchange of changes
+ * between databases (see \l ChangeSet) without scanning the tables.
+ * The deletions are recorded in the deletion log \tt Geloescht, which gets a column \tt GUID for them.
+ */
+bool DBMigrator::changeLog()
+{
+    if(!execute("CREATE TABLE IF NOT EXISTS Aenderungen ("
+                  "ID INTEGER NOT NULL PRIMARY KEY,"
+                  "Tabelle TEXT NOT NULL,"
+                  "GUID TEXT NOT NULL,"
+                  "Art TEXT NOT NULL,"
+                  "Zeit INTEGER NOT NULL"
+                ")", "CREATE TABLE Aenderungen")
+            || !execute("CREATE INDEX IF NOT EXISTS AenderungenZeit ON Aenderungen(Zeit)", "CREATE INDEX AenderungenZeit")) {
+        return false;
+    }
+    if(columnNotExistsForTable("Geloescht", "GUID")
+            && !execute("ALTER TABLE Geloescht ADD COLUMN GUID TEXT", "ALTER TABLE Geloescht (GUID)")) {
+        return false;
+    }
+
+    QStringList tables;
+    tables << "Kurse" << "Module" << "Anerkennungen";
+    for(int i = 0; i < tables.size(); i++) {
+        QString table = tables.at(i);
+        if(columnNotExistsForTable(table, "GUID")
+                && !execute(QString("ALTER TABLE %1 ADD COLUMN GUID TEXT").arg(table), QString("ALTER TABLE %1 (GUID)").arg(table))) {
+            return false;
+        }
+        // the number of the table, the ID and the time of creation as 32 hexadecimal digits
+        QString guid = "GUID = printf('%08x%08x%016x', " + QString::number(i + 1) + ", ID, Erstellt)";
+        bool success = backfill(table, guid, QObject::tr("Identifying the entries..."))
+                && execute(QString("CREATE UNIQUE INDEX IF NOT EXISTS %1GUID ON %1(GUID)").arg(table), QString("CREATE INDEX %1GUID").arg(table))
+                && execute(QString("DROP TRIGGER IF EXISTS Geloescht%1Delete").arg(table), QString("DROP TRIGGER Geloescht%1Delete").arg(table))
+                && createDeletionTriggers(table, true)
+                && createChangeTriggers(table);
+        if(!success) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Creates the triggers which record the changes of \a table in the table \tt Aenderungen
+ *
+ * The trigger on insertion also assigns a random GUID to the new entry, if it has none yet.
+ * The resulting update of the GUID is not recorded as a change.
+ * Deletions are recorded by the triggers of the deletion log, see \l createDeletionTriggers().
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool DBMigrator::createChangeTriggers(const QString &table)
+{
+    QString now = "CAST(strftime('%s', 'now') AS INTEGER)";
+    return execute(QString("CREATE TRIGGER Aenderungen%1Insert AFTER INSERT ON %1 BEGIN "
+                             "UPDATE %1 SET GUID = lower(hex(randomblob(16))) WHERE ID = NEW.ID AND GUID IS NULL; "
+                             "INSERT INTO Aenderungen (Tabelle, GUID, Art, Zeit) SELECT '%1', GUID, 'I', %2 FROM %1 WHERE ID = NEW.ID; "
+                           "END").arg(table).arg(now), QString("CREATE TRIGGER Aenderungen%1Insert").arg(table))
+            && execute(QString("CREATE TRIGGER Aenderungen%1Update AFTER UPDATE ON %1 WHEN OLD.GUID IS NOT NULL BEGIN "
+                                 "INSERT INTO Aenderungen (Tabelle, GUID, Art, Zeit) VALUES ('%1', NEW.GUID, 'U', %2); "
+                               "END").arg(table).arg(now), QString("CREATE TRIGGER Aenderungen%1Update").arg(table));
+}
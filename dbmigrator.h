@@ -0,0 +1,83 @@
+/*
+ * dbmigrator.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DBMIGRATOR_H
+#define DBMIGRATOR_H
+
+#include <QtSql>
+#include <QtDebug>
+#include <QVector>
+#include <QProgressDialog>
+#include <QCoreApplication>
+#include <limits>
+
+class DBMigrator
+{
+public:
+    DBMigrator(QSqlDatabase database);
+    ~DBMigrator();
+
+    static int latestVersion();
+
+    bool migrate(int fromVersion);
+    QString lastError() const;
+
+private:
+    typedef bool (DBMigrator::*MigrationStep)();
+
+    struct Migration {
+        int version;
+        QString name;
+        MigrationStep step;
+    };
+
+    static const QVector<Migration> &migrations();
+
+    QSqlDatabase db;
+    QProgressDialog *progress;
+    QString error;
+
+    bool runMigration(const Migration &migration);
+    bool isRecorded(const QString &name);
+    bool exec(QSqlQuery *query, const QString &method);
+    bool execute(const QString &sql, const QString &method);
+    bool backfill(const QString &table, const QString &assignments, const QString &label, int chunkSize = 2000);
+    bool columnNotExistsForTable(const QString &table, const QString &column);
+    static QString ectsDeviation();
+    bool createEctsTriggers();
+    bool createCounterTriggers(const QString &table);
+    bool rebuildTable(const QString &table, const QString &columns, const QString &select);
+    bool createDeletionTriggers(const QString &table, bool withGuid = false);
+    bool createChangeTriggers(const QString &table);
+
+    // The migration steps
+    bool timestampAddition();
+    bool nameIndexes();
+    bool transferIndexes();
+    bool ectsSummary();
+    bool entryCounters();
+    bool lookupTables();
+    bool epochTimestamps();
+    bool deletionLog();
+    bool changeLog();
+};
+
+#endif // DBMIGRATOR_H
@@ -0,0 +1,125 @@
+/*
+ * entrylookup.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "entrylookup.h"
+
+/*!
+ * \class EntryLookup
+ *
+ * \brief Turns a line edit into a picker for database entries
+ *
+ * While the user types into the line edit, the entries whose name starts with the entered text
+ * are looked up in the database (see \l Database::lookupEntries()) and offered in a completer popup.
+ * Only the first entries in alphabetical order are fetched, so the effort does not depend on the size of the table.
+ *
+ * The lookup is performed when the user pauses typing for a short moment.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the EntryLookup
+ *
+ * The entries of table \a table in \a database are looked up by their name in column \a column.
+ * The columns \a selectcols are fetched, of which the second one is the name displayed in the popup.
+ * The lookup is attached to \a lineEdit and \a parent is passed to the QObject constructor.
+ */
+EntryLookup::EntryLookup(Database *database, const QString &table, const QString &column, const QString &selectcols,
+                         QLineEdit *lineEdit, QObject *parent) :
+    QObject(parent),
+    db(database),
+    table(table),
+    column(column),
+    selectcols(selectcols),
+    limit(50),
+    lineEdit(lineEdit)
+{
+    model = new CompactTableModel(this);
+
+    // The model contains the matches already, so the completer must not filter them again
+    completer = new QCompleter(this);
+    completer->setModel(model);
+    completer->setCompletionColumn(1);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setWidget(lineEdit);
+    connect(completer, SIGNAL(activated(QModelIndex)), this, SLOT(activated(QModelIndex)));
+
+    lookupTimer = new QTimer(this);
+    lookupTimer->setSingleShot(true);
+    lookupTimer->setInterval(150);
+    connect(lookupTimer, SIGNAL(timeout()), this, SLOT(lookup()));
+
+    connect(lineEdit, SIGNAL(textEdited(QString)), this, SLOT(textEdited()));
+}
+
+/*!
+ * \brief Sets the maximal number of entries offered to \a limit
+ *
+ * The default is 50.
+ */
+void EntryLookup::setLimit(int limit)
+{
+    this->limit = limit;
+}
+
+/*!
+ * \brief The user edited the text
+ *
+ * Any previously selected entry is no longer valid, which is signalled by entryCleared().
+ * The lookup is (re)scheduled.
+ */
+void EntryLookup::textEdited()
+{
+    emit entryCleared();
+    lookupTimer->start();
+}
+
+/*!
+ * \brief Looks up the entries matching the current text and shows them in the popup
+ */
+void EntryLookup::lookup()
+{
+    QSqlQuery query = db->lookupEntries(table, column, lineEdit->text(), selectcols, limit);
+    if(query.lastError().isValid()) {
+        qCritical() << QObject::tr("Error in lookup of '%1':").arg(table) << query.lastError();
+    }
+    model->setTable(CompactTable::fromQuery(query));
+
+    if(model->rowCount() > 0) {
+        completer->complete();
+    } else {
+        completer->popup()->hide();
+    }
+}
+
+/*!
+ * \brief The entry at \a index was chosen from the popup
+ *
+ * Its name is set into the line edit and the entry is signalled by entrySelected().
+ */
+void EntryLookup::activated(const QModelIndex &index)
+{
+    if(!index.isValid()) return;
+
+    QSqlRecord record = model->record(index.row());
+    lineEdit->setText(record.value(1).toString());
+    emit entrySelected(record);
+}
@@ -0,0 +1,66 @@
+/*
+ * entrylookup.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENTRYLOOKUP_H
+#define ENTRYLOOKUP_H
+
+#include <QObject>
+#include <QLineEdit>
+#include <QCompleter>
+#include <QAbstractItemView>
+#include <QTimer>
+#include <QtSql>
+#include "database.h"
+#include "compacttablemodel.h"
+
+class EntryLookup : public QObject
+{
+    Q_OBJECT
+
+public:
+    EntryLookup(Database *database, const QString &table, const QString &column, const QString &selectcols,
+                QLineEdit *lineEdit, QObject *parent = nullptr);
+
+    void setLimit(int limit);
+
+signals:
+    void entrySelected(const QSqlRecord &record);
+    void entryCleared();
+
+private slots:
+    void textEdited();
+    void lookup();
+    void activated(const QModelIndex &index);
+
+private:
+    Database *db;
+    QString table;
+    QString column;
+    QString selectcols;
+    int limit;
+
+    QLineEdit *lineEdit;
+    CompactTableModel *model;
+    QCompleter *completer;
+    QTimer *lookupTimer;
+};
+
+#endif // ENTRYLOOKUP_H
@@ -0,0 +1,289 @@
+/*
+ * fuzzymatcher.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "fuzzymatcher.h"
+#include <algorithm>
+
+/*!
+ * \class FuzzyMatcher
+ *
+ * \brief Typo-tolerant search within the names of courses or modules
+ *
+ * A name matches if some part of it differs from the searched text by at most one edit
+ * (insertion, deletion or substitution of a character) per \c fuzzy_error_share characters,
+ * so that "Stochastk" finds "Stochastik für Informatiker". Case is ignored.
+ *
+ * The names are stored one after another in a single array. A search passes two stages:
+ * \list
+ * \li A q-gram filter: each name carries a word whose bits are the hashed bigrams of the name.
+ *     Each edit destroys at most two bigrams of the searched text, so a name needs a minimum number of its bits.
+ *     This test takes a single \c AND and a population count per name.
+ * \li The edit distance of the remaining names is computed with the bit-parallel algorithm of Myers
+ *     in the formulation of Hyyrö, which processes a whole column of the distance matrix in one machine word per character.
+ * \endlist
+ * Large numbers of names are split into chunks, which are searched on the threads of the global thread pool.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs an empty FuzzyMatcher
+ */
+FuzzyMatcher::FuzzyMatcher()
+{
+    offsets << 0;
+}
+
+/*!
+ * \brief Loads the entries returned by \a sql on the database connection \a db
+ *
+ * The query needs to return the ID and the name of each entry in this order.
+ * Returns \c true on success, otherwise \c false and the matcher is empty.
+ */
+bool FuzzyMatcher::load(QSqlDatabase db, const QString &sql)
+{
+    clear();
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if(!query.exec(sql)) {
+        qCritical() << QObject::tr("Database error in '%1': %2").arg("FuzzyMatcher").arg(query.lastError().text());
+        return false;
+    }
+    while(query.next()) {
+        insert(query.value(0).toInt(), query.value(1).toString());
+    }
+    return true;
+}
+
+/*!
+ * \brief Removes all entries
+ */
+void FuzzyMatcher::clear()
+{
+    characters.clear();
+    offsets.clear();
+    offsets << 0;
+    ids.clear();
+    signatures.clear();
+}
+
+/*!
+ * \brief Adds the entry \a id of name \a name
+ */
+void FuzzyMatcher::insert(int id, const QString &name)
+{
+    QString lower = name.toLower();
+    const ushort *text = lower.utf16();
+    for(int i = 0; i < lower.size(); i++) {
+        characters << text[i];
+    }
+    offsets << characters.size();
+    ids << id;
+    signatures << signature(text, lower.size());
+}
+
+/*!
+ * \brief Returns the number of entries
+ */
+int FuzzyMatcher::size() const
+{
+    return ids.size();
+}
+
+/*!
+ * \brief Returns up to \a limit entries whose names contain \a text with few errors
+ *
+ * The matches are ranked by their number of errors, then by the length of their names,
+ * so that a name mostly consisting of the searched text comes first.
+ * Only the first \c fuzzy_max_length characters of \a text are searched.
+ */
+QList<FuzzyMatcher::Match> FuzzyMatcher::search(const QString &text, int limit) const
+{
+    QList<Match> result;
+    QString lower = text.trimmed().toLower().left(fuzzy_max_length);
+    if(lower.isEmpty() || ids.isEmpty()) {
+        return result;
+    }
+
+    Pattern pattern;
+    for(int c = 0; c < 256; c++) {
+        pattern.latinMasks[c] = 0;
+    }
+    const ushort *chars = lower.utf16();
+    for(int i = 0; i < lower.size(); i++) {
+        quint64 bit = Q_UINT64_C(1) << i;
+        if(chars[i] < 256) {
+            pattern.latinMasks[chars[i]] |= bit;
+        } else {
+            pattern.otherMasks[chars[i]] |= bit;
+        }
+    }
+    pattern.length = lower.size();
+    pattern.lastBit = Q_UINT64_C(1) << (pattern.length - 1);
+    // very short texts are searched exactly, otherwise anything would match
+    pattern.maxErrors = (pattern.length < 3) ? 0 : qMax(1, pattern.length / fuzzy_error_share);
+    pattern.signature = signature(chars, pattern.length);
+    pattern.minCommon = int(qPopulationCount(pattern.signature)) - 2 * pattern.maxErrors;
+
+    QList<Job> jobs;
+    for(int begin = 0; begin < ids.size(); begin += fuzzy_chunk_size) {
+        Job job;
+        job.matcher = this;
+        job.pattern = &pattern;
+        job.begin = begin;
+        job.end = qMin(begin + fuzzy_chunk_size, ids.size());
+        jobs << job;
+    }
+
+    // a single chunk is not worth starting a thread
+    QVector<Match> matches;
+    if(jobs.size() == 1) {
+        matches = searchRange(jobs.first());
+    } else {
+        matches = QtConcurrent::blockingMappedReduced<QVector<Match> >(jobs, searchRange, collectMatches);
+    }
+
+    std::sort(matches.begin(), matches.end(), better);
+    for(int i = 0; i < matches.size() && i < limit; i++) {
+        result << matches.at(i);
+    }
+    return result;
+}
+
+/*!
+ * \brief Returns the signature of the \a length characters of \a text
+ *
+ * Each bigram of the text sets one of the 64 bits, chosen by Fibonacci hashing.
+ */
+quint64 FuzzyMatcher::signature(const ushort *text, int length)
+{
+    quint64 bits = 0;
+    for(int i = 1; i < length; i++) {
+        quint32 hash = ((quint32(text[i - 1]) << 16) | text[i]) * 0x9E3779B1u;
+        bits |= Q_UINT64_C(1) << (hash >> 26);
+    }
+    return bits;
+}
+
+/*!
+ * \brief Returns the least edit distance between \a pattern and any part of the \a length characters of \a text
+ *
+ * This is the search variant of the bit-parallel algorithm of Myers: The vertical deltas of the current column
+ * of the distance matrix are kept as bit vectors (\c pv for +1, \c mv for -1) and updated for each character at once.
+ * As the match may start anywhere, the top row of the matrix is zero and no horizontal delta enters from there.
+ * The computation ends early once the distance cannot fall to the tolerated number of errors anymore.
+ */
+int FuzzyMatcher::distance(const Pattern &pattern, const ushort *text, int length)
+{
+    quint64 pv = ~Q_UINT64_C(0);
+    quint64 mv = 0;
+    int score = pattern.length;
+    int best = score;
+    for(int j = 0; j < length; j++) {
+        ushort c = text[j];
+        quint64 eq = (c < 256) ? pattern.latinMasks[c] : pattern.otherMasks.value(c);
+        quint64 xv = eq | mv;
+        quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        quint64 ph = mv | ~(xh | pv);
+        quint64 mh = pv & xh;
+        if(ph & pattern.lastBit) {
+            score++;
+        } else if(mh & pattern.lastBit) {
+            score--;
+        }
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        if(score < best) {
+            best = score;
+            if(best == 0) break;
+        } else if(best > pattern.maxErrors && score - (length - j - 1) > pattern.maxErrors) {
+            // the score decreases by at most one per remaining character
+            break;
+        }
+    }
+    return best;
+}
+
+/*!
+ * \brief Returns the matches among the names of the chunk given by \a job
+ *
+ * The signatures are filtered in a tight loop over consecutive memory first,
+ * only the remaining names are passed to the kernel.
+ */
+QVector<FuzzyMatcher::Match> FuzzyMatcher::searchRange(const Job &job)
+{
+    const FuzzyMatcher *matcher = job.matcher;
+    const Pattern &pattern = *job.pattern;
+
+    QVector<int> candidates;
+    const quint64 *signatures = matcher->signatures.constData();
+    for(int i = job.begin; i < job.end; i++) {
+        if(int(qPopulationCount(signatures[i] & pattern.signature)) >= pattern.minCommon) {
+            candidates << i;
+        }
+    }
+
+    QVector<Match> matches;
+    const ushort *characters = matcher->characters.constData();
+    const int *offsets = matcher->offsets.constData();
+    for(int c = 0; c < candidates.size(); c++) {
+        int i = candidates.at(c);
+        int length = offsets[i + 1] - offsets[i];
+        // too short to contain the text with the tolerated errors
+        if(length < pattern.length - pattern.maxErrors) continue;
+
+        int errors = distance(pattern, characters + offsets[i], length);
+        if(errors <= pattern.maxErrors) {
+            Match match;
+            match.id = matcher->ids.at(i);
+            match.distance = errors;
+            match.length = length;
+            matches << match;
+        }
+    }
+    return matches;
+}
+
+/*!
+ * \brief Appends the \a matches of a chunk to \a result
+ */
+void FuzzyMatcher::collectMatches(QVector<Match> &result, const QVector<Match> &matches)
+{
+    result << matches;
+}
+
+/*!
+ * \brief Returns \c true if the match \a a is ranked before \a b
+ */
+bool FuzzyMatcher::better(const Match &a, const Match &b)
+{
+    if(a.distance != b.distance) {
+        return a.distance < b.distance;
+    }
+    if(a.length != b.length) {
+        return a.length < b.length;
+    }
+    return a.id < b.id;
+}
@@ -0,0 +1,94 @@
+/*
+ * fuzzymatcher.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+
+// Longest searched text, longer ones are cut (the length of a machine word in bits)
+#define fuzzy_max_length 64
+// One error is tolerated per this number of characters of the searched text
+#define fuzzy_error_share 4
+// Number of names searched by a single task of a worker thread
+#define fuzzy_chunk_size 32768
+
+#include <QtSql>
+#include <QtConcurrent>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QString>
+
+class FuzzyMatcher
+{
+public:
+    // Entry whose name contains the searched text with few errors
+    struct Match {
+        int id;
+        int distance;
+        int length;
+    };
+
+    FuzzyMatcher();
+
+    bool load(QSqlDatabase db, const QString &sql);
+    void clear();
+    void insert(int id, const QString &name);
+    int size() const;
+
+    QList<Match> search(const QString &text, int limit) const;
+
+private:
+    // The searched text prepared for the kernel
+    struct Pattern {
+        // Bit i is set in the mask of a character if the character is at position i
+        quint64 latinMasks[256];
+        QHash<ushort, quint64> otherMasks;
+        quint64 lastBit;
+        int length;
+        int maxErrors;
+        quint64 signature;
+        int minCommon;
+    };
+
+    // Range of names searched by a single task
+    struct Job {
+        const FuzzyMatcher *matcher;
+        const Pattern *pattern;
+        int begin;
+        int end;
+    };
+
+    // Lower case names one after another, the name i starts at offsets[i] and ends before offsets[i + 1]
+    QVector<ushort> characters;
+    QVector<int> offsets;
+    QVector<int> ids;
+    // Bigrams of each name hashed to the bits of a word
+    QVector<quint64> signatures;
+
+    static quint64 signature(const ushort *text, int length);
+    static int distance(const Pattern &pattern, const ushort *text, int length);
+    static QVector<Match> searchRange(const Job &job);
+    static void collectMatches(QVector<Match> &result, const QVector<Match> &matches);
+    static bool better(const Match &a, const Match &b);
+};
+
+#endif // FUZZYMATCHER_H
@@ -0,0 +1,239 @@
+/*
+ * lazyrowsizer.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lazyrowsizer.h"
+
+/*!
+ * \class LazyRowSizer
+ *
+ * \brief Adjusts the row heights of a table view to its contents on demand
+ *
+ * In contrast to QTableView::resizeRowsToContents() only the rows within or close to the viewport are measured.
+ * The height of each cell is cached together with the column width it was measured with,
+ * so that resizing a single column only measures the cells of that column again.
+ *
+ * All triggers (scrolling, resizing of columns or of the viewport) are collected and
+ * processed at once when control returns to the event loop.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the LazyRowSizer for the table view \a view
+ *
+ * \a parent is passed to the QObject constructor.
+ * The row sizer listens to the scroll bar, the horizontal header and the viewport of \a view.
+ */
+LazyRowSizer::LazyRowSizer(QTableView *view, QObject *parent) :
+    QObject(parent),
+    view(view),
+    model(nullptr)
+{
+    updateTimer = new QTimer(this);
+    updateTimer->setSingleShot(true);
+    updateTimer->setInterval(0);
+    connect(updateTimer, SIGNAL(timeout()), this, SLOT(updateVisibleRows()));
+
+    connect(view->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(scheduleUpdate()));
+    connect(view->horizontalHeader(), SIGNAL(sectionResized(int,int,int)), this, SLOT(scheduleUpdate()));
+    view->viewport()->installEventFilter(this);
+}
+
+/*!
+ * \brief Sets the model whose rows are sized to \a model
+ *
+ * This needs to be the model which is set to the table view.
+ * Any change in the layout or the contents of the model discards the cached heights.
+ */
+void LazyRowSizer::setModel(QAbstractItemModel *model)
+{
+    if(this->model) {
+        disconnect(this->model, nullptr, this, nullptr);
+    }
+    this->model = model;
+    if(model) {
+        connect(model, SIGNAL(modelReset()), this, SLOT(invalidate()));
+        connect(model, SIGNAL(layoutChanged()), this, SLOT(invalidate()));
+        connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(invalidate()));
+        connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(invalidate()));
+        connect(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)), this, SLOT(invalidate()));
+    }
+    invalidate();
+}
+
+/*!
+ * \brief Discards all cached heights
+ *
+ * The visible rows are measured again as soon as control returns to the event loop.
+ * This is needed when the font of the table view changes.
+ */
+void LazyRowSizer::invalidate()
+{
+    rowCache.clear();
+    scheduleUpdate();
+}
+
+/*!
+ * \brief Watches for resize events of the viewport
+ *
+ * Returns \c false as the event \a event of \a watched is never consumed.
+ */
+bool LazyRowSizer::eventFilter(QObject *watched, QEvent *event)
+{
+    if(event->type() == QEvent::Resize) {
+        scheduleUpdate();
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+/*!
+ * \brief Requests an update of the visible rows
+ *
+ * Several requests before returning to the event loop result in a single update.
+ */
+void LazyRowSizer::scheduleUpdate()
+{
+    if(!updateTimer->isActive()) {
+        updateTimer->start();
+    }
+}
+
+/*!
+ * \brief Returns the range of rows to be measured in \a first and \a last
+ *
+ * The range covers the rows in the viewport and one page of rows above and below.
+ * Returns \c false if there are no rows at all.
+ */
+bool LazyRowSizer::visibleRange(int &first, int &last) const
+{
+    int rowCount = model->rowCount();
+    if(rowCount == 0) return false;
+
+    first = view->rowAt(0);
+    last = view->rowAt(view->viewport()->height() - 1);
+    if(first < 0) first = 0;
+    if(last < 0) last = rowCount - 1;
+
+    int page = last - first + 1;
+    first = qMax(0, first - page);
+    last = qMin(rowCount - 1, last + page);
+    return true;
+}
+
+/*!
+ * \brief Returns the height needed to display the cell in \a row and \a column
+ *
+ * The height is computed the same way QTableView::sizeHintForRow() does for a single cell.
+ */
+int LazyRowSizer::cellHeight(int row, int column) const
+{
+    QModelIndex index = model->index(row, column);
+
+    QStyleOptionViewItem option;
+    option.initFrom(view);
+    option.font = view->font();
+    option.displayAlignment = Qt::AlignLeft | Qt::AlignVCenter;
+    option.textElideMode = view->textElideMode();
+    option.rect = QRect(0, 0, view->columnWidth(column), view->verticalHeader()->defaultSectionSize());
+    if(view->wordWrap()) {
+        option.features |= QStyleOptionViewItem::WrapText;
+    }
+
+    int height = view->itemDelegate(index)->sizeHint(option, index).height();
+    return view->showGrid() ? height + 1 : height;
+}
+
+/*!
+ * \brief Measures the cells of \a row whose column width changed since the last measurement
+ *
+ * The height of the row is then set to the largest cell height.
+ * Returns \c true if the height of the row has been changed.
+ */
+bool LazyRowSizer::updateRow(int row)
+{
+    int columnCount = model->columnCount();
+    RowCache &cache = rowCache[row];
+    if(cache.heights.size() != columnCount) {
+        cache.heights.fill(0, columnCount);
+        cache.widths.fill(-1, columnCount);
+    }
+
+    int height = view->verticalHeader()->minimumSectionSize();
+    for(int column = 0; column < columnCount; ++column) {
+        if(view->isColumnHidden(column)) continue;
+
+        int width = view->columnWidth(column);
+        if(cache.widths.at(column) != width) {
+            cache.heights[column] = cellHeight(row, column);
+            cache.widths[column] = width;
+        }
+        height = qMax(height, cache.heights.at(column));
+    }
+
+    if(view->rowHeight(row) != height) {
+        view->verticalHeader()->resizeSection(row, height);
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * \brief Adjusts the heights of the rows in and around the viewport
+ *
+ * As changing the row heights might bring further rows into the viewport,
+ * the range is determined again until it is stable. Afterwards only the cached heights of that range are kept.
+ */
+void LazyRowSizer::updateVisibleRows()
+{
+    if(!model) return;
+
+    int first, last;
+    bool changed = true;
+    bool measured = false;
+    while(changed && visibleRange(first, last)) {
+        changed = false;
+        measured = true;
+        for(int row = first; row <= last; ++row) {
+            changed |= updateRow(row);
+        }
+    }
+    if(measured) {
+        evictRows(first, last);
+    }
+}
+
+/*!
+ * \brief Discards the cached heights of all rows outside the range from \a first to \a last
+ *
+ * This bounds the cache to the rows around the viewport, however far the view is scrolled.
+ * The heights already set to the discarded rows are kept, they are only measured again when they come close to the viewport.
+ */
+void LazyRowSizer::evictRows(int first, int last)
+{
+    QHash<int, RowCache>::iterator it = rowCache.begin();
+    while(it != rowCache.end()) {
+        if(it.key() < first || it.key() > last) {
+            it = rowCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
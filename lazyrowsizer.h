@@ -0,0 +1,73 @@
+/*
+ * lazyrowsizer.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LAZYROWSIZER_H
+#define LAZYROWSIZER_H
+
+#include <QObject>
+#include <QEvent>
+#include <QTableView>
+#include <QHeaderView>
+#include <QScrollBar>
+#include <QStyleOptionViewItem>
+#include <QAbstractItemDelegate>
+#include <QTimer>
+#include <QHash>
+#include <QVector>
+
+class LazyRowSizer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LazyRowSizer(QTableView *view, QObject *parent = nullptr);
+
+    void setModel(QAbstractItemModel *model);
+
+public slots:
+    void invalidate();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) Q_DECL_OVERRIDE;
+
+private slots:
+    void scheduleUpdate();
+    void updateVisibleRows();
+
+private:
+    // Heights of the cells of a single row and the column widths they were measured with
+    struct RowCache {
+        QVector<int> heights;
+        QVector<int> widths;
+    };
+
+    QTableView *view;
+    QAbstractItemModel *model;
+    QTimer *updateTimer;
+    QHash<int, RowCache> rowCache;
+
+    int cellHeight(int row, int column) const;
+    bool visibleRange(int &first, int &last) const;
+    bool updateRow(int row);
+    void evictRows(int first, int last);
+};
+
+#endif // LAZYROWSIZER_H
@@ -0,0 +1,115 @@
+/*
+ * lookupmodel.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "lookupmodel.h"
+
+/*!
+ * \class LookupModel
+ *
+ * \brief Model of the entries of a table whose name starts with a prefix, which are read in pages
+ *
+ * The entries are looked up by \l Database::lookupEntries() and ordered by their name.
+ * Only the first \c lookup_page_size entries are read initially, further pages are read
+ * when a view asks for them by fetchMore(), e.g. when the list of a combobox is scrolled to its end.
+ *
+ * Each page is read completely and its query is finished right away. So in contrast to a QSqlQueryModel,
+ * which keeps its query open until all entries are fetched, the model does not hold a read lock
+ * on the database file, which would keep other instances from committing their changes.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the LookupModel
+ *
+ * The entries of table \a table in \a database are looked up by their name in column \a column.
+ * The columns \a selectcols are read. The model is empty until a prefix is set by \l setPrefix().
+ * \a parent is passed to the CompactTableModel constructor.
+ */
+LookupModel::LookupModel(Database *database, const QString &table, const QString &column, const QString &selectcols,
+                         QObject *parent) :
+    CompactTableModel(parent),
+    db(database),
+    table(table),
+    column(column),
+    selectcols(selectcols),
+    complete(true)
+{
+}
+
+/*!
+ * \brief Reads the first page of entries whose name starts with \a prefix
+ *
+ * The entries read before are discarded, so this also reloads the entries after the data changed.
+ */
+void LookupModel::setPrefix(const QString &prefix)
+{
+    namePrefix = prefix;
+    complete = false;
+    setTable(readPage(0));
+}
+
+/*!
+ * \brief Returns the prefix of the names set by \l setPrefix()
+ */
+QString LookupModel::prefix() const
+{
+    return namePrefix;
+}
+
+/*!
+ * \brief Returns \c true if there may be further entries which have not been read yet
+ *
+ * As the model is a flat table, \c false is returned for any valid \a parent.
+ */
+bool LookupModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !complete;
+}
+
+/*!
+ * \brief Reads the next page of entries and appends them
+ *
+ * The model is not reset, so the current entry of a view stays selected.
+ * Nothing is done for a valid \a parent.
+ */
+void LookupModel::fetchMore(const QModelIndex &parent)
+{
+    if(!canFetchMore(parent)) return;
+    appendTable(readPage(rowCount()));
+}
+
+/*!
+ * \brief Returns the page of entries starting at \a offset
+ *
+ * If the page is not full, the model is marked as complete.
+ */
+CompactTable LookupModel::readPage(int offset)
+{
+    QSqlQuery query = db->lookupEntries(table, column, namePrefix, selectcols, lookup_page_size, offset);
+    if(query.lastError().isValid()) {
+        qCritical() << tr("Error in lookup of '%1':").arg(table) << query.lastError();
+    }
+    CompactTable page = CompactTable::fromQuery(query);
+    complete = page.rowCount() < lookup_page_size;
+    return page;
+}
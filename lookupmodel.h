@@ -0,0 +1,59 @@
+/*
+ * lookupmodel.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LOOKUPMODEL_H
+#define LOOKUPMODEL_H
+
+// Number of entries read at once by a LookupModel
+#define lookup_page_size 200
+
+#include <QtSql>
+#include "database.h"
+#include "compacttablemodel.h"
+
+class LookupModel : public CompactTableModel
+{
+    Q_OBJECT
+
+public:
+    LookupModel(Database *database, const QString &table, const QString &column, const QString &selectcols,
+                QObject *parent = nullptr);
+
+    void setPrefix(const QString &prefix);
+    QString prefix() const;
+
+    bool canFetchMore(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    void fetchMore(const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE;
+
+private:
+    Database *db;
+    QString table;
+    QString column;
+    QString selectcols;
+    QString namePrefix;
+    // Whether the last page was not full, so there are no further entries
+    bool complete;
+
+    CompactTable readPage(int offset);
+};
+
+#endif // LOOKUPMODEL_H
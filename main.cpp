@@ -23,22 +23,33 @@
 #include <QApplication>
 #include <QtDebug>
 #include <QtGlobal>
+#include <QTimer>
 #include "configmanager.h"
+#include "startupprofile.h"
 
 int main(int argc, char *argv[])
 {
+    StartupProfile::start();
     QApplication a(argc, argv);
     a.setApplicationName("AnerkennungsDB");
     //a.setOrganizationName("PaulFink");
     a.setWindowIcon(QIcon(":/images/akdb128.png"));
+    StartupProfile::mark("application");
 
     MainWindow w;
+    StartupProfile::mark("main window");
     if(!w.initDatabase()) {
         // Failed to connect to database
         return 1;
     }
     w.initGuiElements();
+    StartupProfile::mark("GUI elements");
     w.show();
+    StartupProfile::mark("show");
+    StartupProfile::finishOnPaint(&w);
+
+    // The translations of the texts within Qt itself are not needed for the first paint
+    QTimer::singleShot(0, ConfigManager::getInstance(), SLOT(loadQtTranslations()));
 
     return a.exec();
 }
@@ -43,18 +43,42 @@ MainWindow::MainWindow(QWidget *parent) :
     ui(new Ui::MainWindow),
     ididx(-1),
     lastididx(-1),
+    nameIndex(-1),
     lastTableIndex(-1),
-    hasSearched(false), allowResize(true)
+    hasSearched(false), allowResize(true),
+    prefetchVersion(-1),
+    persistLabel(nullptr),
+    persistTimer(nullptr),
+    changeTimer(nullptr)
 {
     ConfigManager::getInstance()->loadSettings();
     ui->setupUi(this);
-    tableModel = new QSqlQueryModel();
-    qsfpm = new QSortFilterProxyModel();
-    readonlyModel = new QSqlQueryModel();
-    readonlyProxy = new QSortFilterProxyModel();
-    searchWidgetStack = new QStack<QLayoutItem*>();
+    tableModel = new CompactTableModel(this);
+    rowSizer = new LazyRowSizer(ui->viewTable, this);
+    rowSizer->setModel(tableModel);
+    widthEstimator = new ColumnWidthEstimator(&db);
+
+    // The prefetcher works in a thread of its own and is destroyed when the thread finishes
+    TransferPrefetcher::registerMetaTypes();
+    prefetchThread = new QThread(this);
+    prefetcher = new TransferPrefetcher();
+    prefetcher->moveToThread(prefetchThread);
+    connect(prefetchThread, SIGNAL(finished()), prefetcher, SLOT(deleteLater()));
+    connect(this, SIGNAL(prefetchRequested(QString,QString,QStringList,int)), prefetcher, SLOT(prefetch(QString,QString,QStringList,int)));
+    connect(prefetcher, SIGNAL(prefetched(QString,QString,int,QSqlRecord,QVector<QSqlRecord>)),
+            this, SLOT(neighbourPrefetched(QString,QString,int,QSqlRecord,QVector<QSqlRecord>)));
+    connect(prefetcher, SIGNAL(prefetchFailed(QString,QStringList,int)), this, SLOT(neighbourPrefetchFailed(QString,QStringList,int)));
+    prefetchThread->start();
+
+    // Changes of other instances are looked for regularly, if there can be any (see initPersistStatus())
+    changeTimer = new QTimer(this);
+    changeTimer->setInterval(change_poll_interval);
+    connect(changeTimer, SIGNAL(timeout()), this, SLOT(pollExternalChanges()));
+
     filefiltersSqlite << tr("SQLite database (*.sqlite)") << tr("All files (*)");
     filefiltersCsv << tr("CSV (*.csv)") << tr("All files (*)");
+    filefiltersChangeset << tr("Changeset (*.changeset)") << tr("All files (*)");
+    filefiltersDump << tr("Binary dump (*.adbdump)") << tr("All files (*)");
 }
 
 /*!
@@ -64,15 +88,10 @@ MainWindow::MainWindow(QWidget *parent) :
  */
 MainWindow::~MainWindow()
 {
-    if(searchWidgetStack) {
-        while(searchWidgetStack->count()>0) {
-            ui->scrollSearchContents->layout()->addItem(searchWidgetStack->pop());
-        }
-        delete searchWidgetStack;
-    }
-    delete qsfpm;
-    delete readonlyProxy;
-    delete tableModel;
+    prefetchThread->quit();
+    prefetchThread->wait();
+    clearSelectorModels();
+    delete widthEstimator;
     delete ui;
 }
 
@@ -82,7 +101,181 @@ MainWindow::~MainWindow()
  * If opening the database is successful \c true is returned, otherwise \c false.
  */
 bool MainWindow::initDatabase() {
-    return this->db.openDatabase();
+    bool success = this->db.openDatabase();
+    initPersistStatus();
+    return success;
+}
+
+/*!
+ * \brief Sets up the display of the in-memory working copy status
+ *
+ * In the in-memory mode a permanent label in the status bar shows whether all changes have been written
+ * to the database file, the time of the last writing and how long the changes waited for it.
+ * It is updated every second. In the read-only snapshot mode the label states so and the import of a database
+ * is disabled. Otherwise the label is hidden.
+ *
+ * The polling for changes of other instances only runs when accessing the database file directly,
+ * as nobody else can change the working copy or the snapshot.
+ *
+ * This needs to be called after each opening of the database.
+ *
+ * \since 3.3
+ */
+void MainWindow::initPersistStatus()
+{
+    if(!persistLabel) {
+        persistLabel = new QLabel(this);
+        statusBar()->addPermanentWidget(persistLabel);
+        persistTimer = new QTimer(this);
+        persistTimer->setInterval(1000);
+        connect(persistTimer, SIGNAL(timeout()), this, SLOT(updatePersistStatus()));
+    }
+
+    DatabasePersister *persister = db.getPersister();
+    if(persister) {
+        connect(persister, SIGNAL(stateChanged()), this, SLOT(updatePersistStatus()));
+        persistTimer->start();
+        if(persister->isNative()) {
+            persistLabel->setToolTip(tr("Changes are written to the database file in small steps in the background."));
+        } else {
+            persistLabel->setToolTip(tr("This build rewrites the whole database file on every save. "
+                                        "Build with system SQLite (qmake CONFIG+=system_sqlite) to write it in small steps."));
+        }
+        persistLabel->show();
+    } else if(db.isReadOnly()) {
+        persistTimer->stop();
+        persistLabel->setText(tr("Read-only snapshot"));
+        persistLabel->setToolTip(QString());
+        persistLabel->show();
+    } else {
+        persistTimer->stop();
+        persistLabel->hide();
+    }
+    // A snapshot shared with others must not be replaced
+    ui->actionRestore->setEnabled(!db.isReadOnly());
+    ui->actionExportDelta->setEnabled(!db.isReadOnly());
+    ui->actionExportChanges->setEnabled(!db.isReadOnly());
+    ui->actionApplyChanges->setEnabled(!db.isReadOnly());
+    ui->actionRestoreDump->setEnabled(!db.isReadOnly());
+    if(db.canChangeExternally()) {
+        changeTimer->start();
+    } else {
+        changeTimer->stop();
+    }
+    updatePersistStatus();
+}
+
+/*!
+ * \brief Updates the status of the in-memory working copy in the status bar
+ *
+ * \since 3.3
+ */
+void MainWindow::updatePersistStatus()
+{
+    DatabasePersister *persister = db.getPersister();
+    if(!persister) return;
+
+    QString text;
+    if(persister->isDirty()) {
+        text = tr("Unsaved changes for %1 s").arg(persister->dirtySince().secsTo(QDateTime::currentDateTime()));
+    } else if(persister->lastFlush().isValid()) {
+        text = tr("Saved at %1 (after %2 s)").arg(persister->lastFlush().toString("hh:mm:ss"))
+                .arg(persister->lastLag() / 1000.0, 0, 'f', 1);
+    } else {
+        text = tr("Working copy in memory");
+    }
+    persistLabel->setText(text);
+}
+
+/*!
+ * \brief Looks for changes of the database by other instances
+ *
+ * This is called every \c change_poll_interval ms while the database file is accessed directly.
+ * While a dialog is open, the check is postponed until it is closed.
+ *
+ * If another instance changed one of the tables shown by the current view (see viewTables()),
+ * or the changed tables are unknown, the table view is refreshed by refreshView().
+ *
+ * \since 3.3
+ * \sa Database::hasExternalChanges()
+ */
+void MainWindow::pollExternalChanges()
+{
+    if(QApplication::activeModalWidget()) return;
+
+    QStringList tables;
+    if(!db.hasExternalChanges(&tables)) return;
+    QStringList shown = viewTables(getCurrentView());
+    bool affected = tables.isEmpty();
+    for(int i = 0; i < tables.size() && !affected; i++) {
+        affected = shown.contains(tables.at(i));
+    }
+    if(affected) {
+        refreshView();
+    }
+}
+
+/*!
+ * \brief Returns the tables with change log whose entries are shown in \a view
+ *
+ * \since 3.3
+ */
+QStringList MainWindow::viewTables(const QString &view)
+{
+    QStringList tables;
+    if(view == "Kurse" || view == "Module") {
+        tables << view;
+    } else if(view == "anerkmodule") {
+        tables << "Anerkennungen" << "Kurse";
+    } else if(view == "anerkkurse") {
+        tables << "Anerkennungen" << "Module";
+    } else {
+        tables << "Anerkennungen" << "Kurse" << "Module";
+    }
+    return tables;
+}
+
+/*!
+ * \brief Repeats the query of the table view
+ *
+ * The displayed query is executed again with the same restrictions.
+ * The sorting, the selected entry and the scroll position are kept, so that the view only changes
+ * where the entries have been changed.
+ *
+ * \since 3.3
+ */
+void MainWindow::refreshView()
+{
+    QString view = getCurrentView();
+    if(view.isEmpty() || shownQuery.table != view) return;
+
+    QString selectedId = getSelectedId();
+    QHeaderView *header = ui->viewTable->horizontalHeader();
+    int sortColumn = header->sortIndicatorSection();
+    Qt::SortOrder sortOrder = header->sortIndicatorOrder();
+    int vertical = ui->viewTable->verticalScrollBar()->value();
+    int horizontal = ui->viewTable->horizontalScrollBar()->value();
+
+    // The search condition rows are only reset if no search was applied
+    ShownQuery query = shownQuery;
+    adjustModel(query.table, query.filter);
+
+    if(sortColumn > -1 && sortColumn < tableModel->columnCount()) {
+        ui->viewTable->sortByColumn(sortColumn, sortOrder);
+    }
+    if(!selectedId.isEmpty() && ididx > -1) {
+        for(int row = 0; row < tableModel->rowCount(); row++) {
+            if(tableModel->index(row, ididx).data().toString() == selectedId) {
+                ui->viewTable->selectRow(row);
+                break;
+            }
+        }
+    }
+    ui->viewTable->verticalScrollBar()->setValue(vertical);
+    ui->viewTable->horizontalScrollBar()->setValue(horizontal);
+    enableModify();
+    enablePrint();
+    statusBar()->showMessage(tr("The view has been updated with changes of another instance."), 5000);
 }
 
 /*!
@@ -101,6 +294,7 @@ bool MainWindow::initDatabase() {
  *   \endlist
  *   \li Putting the hidden condition rows on a stack
  *   \li Changing the looks for the tableView if on Windows 10
+ *   \li Connecting a column resize in the tableView to saving the column sizes
  *   \li Dis-/Enable elements for the readOnly view (which takes care of enabling the search buttons) via \l MainWindow::visibilityReadonly
  *   \li Disable the add/modify/delete buttons via \l MainWindow::enableModify()
  *   \li Disable the print entry in menu via \l MainWindow::enablePrint()
@@ -125,46 +319,32 @@ bool MainWindow::initGuiElements()
         viewBox->addItem(tr("Courses per module (not editable)"), "anerkmodule");
         viewBox->addItem(tr("Modules per course (not editable)"), "anerkkurse");
         viewBox->addItem(tr("Transfers"), "Anerkennungen");
+        viewBox->addItem(tr("ECTS deviations (not editable)"), "ectsabweichungen");
         viewBox->setCurrentIndex(-1);
         viewBox->blockSignals(false);
     }
 
-    // create 'max_search' rows of gui elements for a single search condition
-    // All required GUI elements are defined in the UI
-    for (int i = 0; i < max_search; i++) {
-
-        QWidget *scrollWidget = ui->scrollSearchContents->findChild<QWidget *>(QString("scrollSearchWidget%1").arg(i));
-        if(scrollWidget && i!=0) scrollWidget->hide();
-
-        QComboBox *relationBox = ui->scrollSearchContents->findChild<QComboBox *>(QString("scrollSearchRelation%1").arg(i));
-        if(relationBox) {
-            relationBox->addItem(tr("contains"), " LIKE ");
-            relationBox->addItem(tr("does not contain"), " NOT LIKE ");
-            relationBox->addItem(tr("equals"), " IS ");
-            relationBox->addItem(tr("does not equal"), " IS NOT ");
-        }
-
-        QLineEdit *inputEdit = ui->scrollSearchContents->findChild<QLineEdit *>(QString("scrollSearchInput%1").arg(i));
-        if(inputEdit) {
-            inputEdit->setClearButtonEnabled(true);
-        }
-
-        QPushButton *addButton = ui->scrollSearchContents->findChild<QPushButton *>(QString("scrollSearchAdd%1").arg(i));
-        if(addButton) {
-            connect(addButton, SIGNAL(clicked()), this, SLOT(searchConditionAdd()));
-        }
-
-        QPushButton *removeButton = ui->scrollSearchContents->findChild<QPushButton *>(QString("scrollSearchRemove%1").arg(i));
-        if(removeButton) {
-            if(i == 0) removeButton->setEnabled(false);
-            connect(removeButton, SIGNAL(clicked()), this, SLOT(searchConditionRemove()));
+    // a single search condition row to start with, further ones are created on demand
+    createSearchRow();
+    enableSearchRemove();
+
+    // the time restriction of the search: entries changed since a date or created within a semester
+    ui->searchTimeBox->addItem(tr("At any time"), "");
+    ui->searchTimeBox->addItem(tr("Changed since"), "changed");
+    ui->searchTimeBox->addItem(tr("Created in"), "semester");
+    ui->searchTimeDate->setDate(QDate::currentDate().addMonths(-1));
+    QDate semester = semesterStart(QDate::currentDate());
+    for(int i = 0; i < max_semesters; i++) {
+        QString name;
+        if(semester.month() == 10) {
+            name = tr("Winter term %1/%2").arg(semester.year()).arg((semester.year() + 1) % 100, 2, 10, QChar('0'));
+        } else {
+            name = tr("Summer term %1").arg(semester.year());
         }
+        ui->searchSemesterBox->addItem(name, semester);
+        semester = semesterStart(semester.addDays(-1));
     }
-
-    // Push the hidden ones onto a stack in reverse ordered, so that element with id=1 is  on top (id=0 is visible)
-    for(int i = (max_search - 1); i > 0; i--) {
-        searchWidgetStack->push(ui->scrollSearchContents->layout()->takeAt(i));
-    }
+    on_searchTimeBox_currentIndexChanged(0);
 
 #ifdef Q_OS_WIN
     if(QSysInfo::windowsVersion()==QSysInfo::WV_WINDOWS10)
@@ -178,6 +358,11 @@ bool MainWindow::initGuiElements()
                     "padding:4px;"
                 "}");
 #endif
+    // connect a column header resize event to a slot saving the column sizes
+    // (the row heights are adapted by the LazyRowSizer)
+    connect(ui->viewTable->horizontalHeader(), SIGNAL(sectionResized(int, int, int)), this,
+            SLOT(tableView_headerResized(int, int, int)));
+
     visibilityReadonly(); // also takes care of enabling the search buttons
     enableModify();
     enablePrint();
@@ -186,7 +371,7 @@ bool MainWindow::initGuiElements()
 }
 
 /*!
- * \fn MainWindow::adjustModel(const QString &table, const QStringList &addcols = QStringList(), const QStringList &addvals = QStringList(), const QStringList &connectrelation = QStringList())
+ * \fn MainWindow::adjustModel(const QString &table, const SearchFilter &filter = SearchFilter())
  *
  * \brief Main function adjusting the contents of the table view
  *
@@ -194,17 +379,20 @@ bool MainWindow::initGuiElements()
  * Furthermore, it makes sure that the GUI is adapted accordingly to the contents displayed in it.
  *
  * The contents of the database table of name \a table are displayed in it.
- * The additional arguments \a addcols, \a addvals and \a connectrelation are used to restrict the contents queried from the database (see also \l Database::executeQuery())
+ * The additional argument \a filter is used to restrict the contents queried from the database (see also \l Database::executeQuery())
  *
  * If the table is not read-only, a text will be displayed in the status bar
  * on how many of the entries of that database table are actually displayed.
  */
-void MainWindow::adjustModel(const QString &table, const QStringList &addcols, const QStringList &addvals, const QStringList &connectrelation)
+void MainWindow::adjustModel(const QString &table, const SearchFilter &filter)
 {
 
+    // remember the query to repeat it on changes by other instances
+    shownQuery.table = table;
+    shownQuery.filter = filter;
+
     // first all models are cleared
     tableModel->clear();
-    qsfpm->clear();
 
     // if table is empty just return
     if(table.isEmpty()) {
@@ -216,41 +404,25 @@ void MainWindow::adjustModel(const QString &table, const QStringList &addcols, c
     ui->viewTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
 
     // Create the basic elements for Database::executeQuery()
-    QString mytable = table;
+    QString mytable = Database::displayTable(table);
     QString selectcols = "*";
 
     // If Anerkennungen table is to be displayed, the statement needs to be adjusted to perform the actual join, otherwise only IDs would be displayed
     if(table == "Anerkennungen") {
-        mytable = "Module M JOIN Anerkennungen A ON M.ID = A.MID JOIN Kurse K ON K.ID = A.KID";
-        selectcols = "A.ID AS ID, K.Kursname AS 'Kurs-Name', K.ECTS AS 'Kurs-ECTS', K.Herkunft AS 'Kurs-Herkunft', M.Modulname AS 'Modul-Name', M.ECTS AS 'Modul-ECTS', M.PO AS 'Modul-PO', A.Datum AS 'Datum'";
+        mytable = "Module M JOIN Anerkennungen A ON M.ID = A.MID JOIN Kurse K ON K.ID = A.KID "
+                  "LEFT JOIN Herkunft H ON H.ID = K.HID LEFT JOIN PO P ON P.ID = M.POID";
+        selectcols = "A.ID AS ID, K.Kursname AS 'Kurs-Name', K.ECTS AS 'Kurs-ECTS', H.Name AS 'Kurs-Herkunft', M.Modulname AS 'Modul-Name', M.ECTS AS 'Modul-ECTS', P.Name AS 'Modul-PO', "
+                     "datetime(A.Zeit, 'unixepoch', 'localtime') AS 'Datum'";
     }
 
-    QStringList addcolums, addvalues, connectrel;
-
-    // if the readonlyId contains an element, add it at first into the list of restrictions
+    // if the readonlyId contains an element, it is required in addition to the restriction
+    SearchFilter restriction = filter;
     if(!readonlyId.isEmpty()) {
-        addcolums.append("ID IS ");
-        addvalues.append(readonlyId);
-        connectrel.append(" AND (");
+        restriction = SearchFilter::all(QList<SearchFilter>() << SearchFilter::condition("ID", SearchFilter::Equals, readonlyId) << filter);
     }
-    addcolums.append(addcols);
-    addvalues.append(addvals);
-    connectrel.append(connectrelation);
 
-    QSqlQuery selectquery = db.executeQuery(mytable, addcolums, addvalues, selectcols, connectrel);
-    if(selectquery.lastError().isValid()) {
-        qCritical() << tr("Error in query 'selectquery':") << selectquery.lastError();
-    }
-
-    // set the query to the model
-    tableModel->setQuery(selectquery);
-    if(tableModel->lastError().isValid()){
-        qCritical() << tr("Error setting query to 'tableModel':") << tableModel->lastError();
-    }
-
-    // As QSqlQuery does lazy loading, so not all are initially displayed
-    // Fetching all entries first allows to display all as desired
-    while (tableModel->canFetchMore()) tableModel->fetchMore();
+    // The result comes from the cache if the same query was executed (or prefetched) since the last change
+    tableModel->setTable(db.fetchTable(mytable, restriction, selectcols));
 
     // disallow save of column sizes
     allowResize = false;
@@ -272,15 +444,15 @@ void MainWindow::adjustModel(const QString &table, const QStringList &addcols, c
             } else if(QString("Kurs-ECTS").compare(colname, Qt::CaseInsensitive) == 0) {
                 columnnames.insert(colname, "K.ECTS");
             } else if(QString("Kurs-Herkunft").compare(colname, Qt::CaseInsensitive) == 0) {
-                columnnames.insert(colname, "K.Herkunft");
+                columnnames.insert(colname, "H.Name");
             } else if(QString("Modul-Name").compare(colname, Qt::CaseInsensitive) == 0) {
                 columnnames.insert(colname, "M.Modulname");
             } else if(QString("Modul-ECTS").compare(colname, Qt::CaseInsensitive) == 0) {
                 columnnames.insert(colname, "M.ECTS");
             } else if(QString("Modul-PO").compare(colname, Qt::CaseInsensitive) == 0) {
-                columnnames.insert(colname, "M.PO");
+                columnnames.insert(colname, "P.Name");
             } else if(QString("Datum").compare(colname, Qt::CaseInsensitive) == 0) {
-                columnnames.insert(colname, "A.Datum");
+                columnnames.insert(colname, "datetime(A.Zeit, 'unixepoch', 'localtime')");
             }
         } else {
             // directly store header names (which are same as database column names) in map
@@ -289,13 +461,8 @@ void MainWindow::adjustModel(const QString &table, const QStringList &addcols, c
         tableModel->setHeaderData(i, Qt::Horizontal, colname);
     }
 
-    //Create a proxy model to allow for sorting
-    qsfpm->setSourceModel(tableModel);
-    qsfpm->setSortLocaleAware(true);
-    qsfpm->sort(-1, Qt::AscendingOrder);
-
-    // table view takes proxy model as model
-    ui->viewTable->setModel(qsfpm);
+    // the model sorts itself with cached collation keys, see CompactTableModel::sort()
+    ui->viewTable->setModel(tableModel);
 
     // Hide the ID column:
     // First unhide the previous id column and then id the new one
@@ -308,7 +475,18 @@ void MainWindow::adjustModel(const QString &table, const QStringList &addcols, c
     }
 
     // Customisation of the features of the table view
-    ui->viewTable->resizeColumnsToContents();
+    // The column widths are estimated from a sample of the longest entries instead of measuring every cell
+    QHeaderView *header = ui->viewTable->horizontalHeader();
+    QStringList headercols;
+    for(int i = 0; i < tableModel->columnCount(); i++) {
+        headercols << tableModel->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
+    }
+    QVector<int> widths = widthEstimator->estimate(table, mytable, selectcols, headercols, ui->viewTable->fontMetrics());
+    for(int i = 0; i < widths.size(); i++) {
+        if(!header->isSectionHidden(i)) {
+            header->resizeSection(i, qMax(widths.at(i), header->sectionSizeHint(i)));
+        }
+    }
 
     // allow save of column sizes
     allowResize = true;
@@ -321,46 +499,38 @@ void MainWindow::adjustModel(const QString &table, const QStringList &addcols, c
     ui->viewTable->setSortingEnabled(true);
 
     // connect a row change to a (custom) signal
+    // (the view keeps its selection model as long as the model is the same, so connect only once)
     connect(ui->viewTable->selectionModel(), SIGNAL(currentRowChanged(QModelIndex,QModelIndex)),
-                this, SLOT(tableViewSelectionModel_currentRowChanged(QModelIndex, QModelIndex)));
-    // connect a column header rezise event to a slot performing row height resizing
-    connect(ui->viewTable->horizontalHeader(), SIGNAL(sectionResized(int, int, int)), this,
-            SLOT(tableView_headerResized(int, int, int)));
+                this, SLOT(tableViewSelectionModel_currentRowChanged(QModelIndex, QModelIndex)), Qt::UniqueConnection);
     // restore the saved sizes
     restoreSizeViewColumns();
-    ui->viewTable->resizeRowsToContents();
-
+    // only the rows around the viewport are sized to their contents
+    rowSizer->invalidate();
 
 
     // insert the column names into the comboboxes of the search condition rows
     nameIndex = -1;
-    if(addvals.isEmpty() && addcols.isEmpty()) {
-
-        for(int i = 0; i < max_search; i++) {
-            QComboBox *searchCategoryBox = ui->scrollSearchContents->findChild<QComboBox *>(QString("scrollSearchField%1").arg(i));
-            searchCategoryBox->clear();
-            // Let the header names be displayed, the database names are stored in a differnt role
-            QMap<QString,QString>::const_iterator it = columnnames.constBegin();
-            while (it != columnnames.constEnd()) {
-                searchCategoryBox->addItem(it.key(),it.value());
-                ++it;
-            };
-            // sort the texts
-            searchCategoryBox->model()->sort(0);
+    if(filter.isEmpty()) {
+
+        // Let the header names be displayed, the database names are stored in a differnt role
+        searchFields = columnnames;
+        for(int i = 0; i < searchRows.size(); i++) {
+            searchRows.at(i)->setFields(searchFields);
             if(nameIndex < 0) {
-                nameIndex  = searchCategoryBox->findData("name", Qt::UserRole, Qt::MatchContains);
+                nameIndex = searchRows.at(i)->findField("name");
             }
             // pre-select the combobox entry which has "name" in it
-            searchCategoryBox->setCurrentIndex(nameIndex);
+            searchRows.at(i)->reset(nameIndex);
         }
     }
 
     // dis- or enable the search buttons
     enableSearchButtons();
+    updateDetailPane();
 
     // Display text in status bar
     if(!isReadonly(table)) {
-        statusBar()->showMessage(tr("Displaying %1 of %2 entries").arg(qsfpm->rowCount()).arg(db.countEntries(table)), 10000);
+        statusBar()->showMessage(tr("Displaying %1 of %2 entries").arg(tableModel->rowCount()).arg(db.countEntries(table)), 10000);
     } else {
         statusBar()->clearMessage();
     }
@@ -454,6 +624,7 @@ void MainWindow::enableSearchButtons()
     }
     ui->searchButtonsSearch->setEnabled(isNotEmptyView);
     ui->searchButtonsReset->setEnabled(isNotEmptyView && hasSearched);
+    ui->searchTimeWidget->setEnabled(hasTimes(view));
 }
 
 /*!
@@ -461,49 +632,39 @@ void MainWindow::enableSearchButtons()
  *
  * A further combobox is displayed in readonly mode to select a specific/course module and display the transfers for it
  * This function checks for the appropriate visibility of the element:
- * For a read-only table the combobox is displayed and populated.
+ * For a read-only table the combobox is displayed and populated with the model from \l selectorModel().
  * Otherwise it is hidden, as well as all read-only elements/members are resetted.
  */
 void MainWindow::visibilityReadonly()
 {
     QString view = getCurrentView();
-    readonlyModel->clear();
-    readonlyProxy->clear();
 
     // if the current table is a readonly, display another combobox
     if(isReadonly(view)) {
 
         // unhide the combobox
         ui->readonlywidget->show();
+        ui->readonlyLabel->setText(((view == "anerkkurse") ? tr("Course") : tr("Module")) + ": ");
 
-        // create aproxy model which has condensed information on the courses/modules
-        QString columns, table, label;
-        if(view == "anerkkurse") {
-            columns = "ID, (Kursname || ' [' || ECTS || ']') AS Name";
-            table = "Kurse";
-            label = tr("Course") + ": ";
+        // restore the filter the cached model was created with
+        if(selectorModels.contains(view)) {
+            ui->readonlyFilterEdit->setText(selectorModels.value(view).model->prefix());
         } else {
-            columns = "ID, (Modulname || ' [' || ECTS || ']') AS Name";
-            table = "Module";
-            label = tr("Module") + ": ";
+            ui->readonlyFilterEdit->clear();
         }
-        readonlyModel->setQuery(db.executeQuery(table,QStringList(),QStringList(),columns));
-        readonlyProxy->setSourceModel(readonlyModel);
-        readonlyProxy->setSortLocaleAware(true);
-        readonlyProxy->sort(1, Qt::AscendingOrder);
 
         // Disable signals to avoid event triggered when setting the model to the combobox
         ui->readonlyComboBox->blockSignals(true);
-        ui->readonlyComboBox->setModel(readonlyProxy);
+        ui->readonlyComboBox->setModel(selectorModel(view));
         ui->readonlyComboBox->setModelColumn(1);
         ui->readonlyComboBox->setCurrentIndex(-1);
         ui->readonlyComboBox->blockSignals(false);
-        ui->readonlyLabel->setText(label);
     } else {
         // no readonly mode, so rewind everything and hide the combobox
         ui->readonlywidget->hide();
+        ui->readonlyComboBox->blockSignals(true);
         ui->readonlyComboBox->setCurrentIndex(-1);
-        ui->readonlyComboBox->clear();
+        ui->readonlyComboBox->blockSignals(false);
         readonlyId.clear();
     }
 
@@ -511,6 +672,58 @@ void MainWindow::visibilityReadonly()
     enableSearchButtons();
 }
 
+/*!
+ * \brief Returns the model of the read-only view selector for \a view
+ *
+ * The model lists the courses (for view \tt anerkkurse) or modules (otherwise) whose name starts with the
+ * text of the filter line edit, ordered by their name as given by the name index.
+ * The LookupModel reads the entries in pages as they are displayed, so only the first ones are loaded initially.
+ * As each page is read completely, no query stays open and blocks other instances from writing to the database file.
+ *
+ * The model is kept for each view and only queried again when the filter or the data of the database changed.
+ *
+ * \since 3.3
+ */
+LookupModel *MainWindow::selectorModel(const QString &view)
+{
+    SelectorModel &selector = selectorModels[view];
+    QString filter = ui->readonlyFilterEdit->text();
+    if(!selector.model) {
+        if(view == "anerkkurse") {
+            selector.model = new LookupModel(&db, "Kurse", "Kursname", "ID, (Kursname || ' [' || ECTS || ']') AS Name", this);
+        } else {
+            selector.model = new LookupModel(&db, "Module", "Modulname", "ID, (Modulname || ' [' || ECTS || ']') AS Name", this);
+        }
+    } else if(selector.dataVersion == db.dataVersion() && selector.model->prefix() == filter) {
+        return selector.model;
+    }
+
+    selector.model->setPrefix(filter);
+    selector.dataVersion = db.dataVersion();
+    return selector.model;
+}
+
+/*!
+ * \brief Removes all models of the read-only view selector
+ *
+ * This needs to be done before the database is closed, as the models refer to its entries.
+ *
+ * \since 3.3
+ */
+void MainWindow::clearSelectorModels()
+{
+    ui->readonlyComboBox->blockSignals(true);
+    ui->readonlyComboBox->setModel(new QStandardItemModel(ui->readonlyComboBox));
+    ui->readonlyComboBox->blockSignals(false);
+
+    QHash<QString, SelectorModel>::iterator it = selectorModels.begin();
+    while(it != selectorModels.end()) {
+        delete it.value().model;
+        ++it;
+    }
+    selectorModels.clear();
+}
+
 /*!
  * \brief Resets the view and Search area
  *
@@ -531,17 +744,10 @@ void MainWindow::resetViewAndSearch(bool makeEmpty)
         nameIndex = -1;
     }
     adjustModel(view);
-    for(unsigned int i = 0; i < max_search; i++) {
-
-        QComboBox *searchFieldBox = ui->scrollSearchContents->findChild<QComboBox *>(QString("scrollSearchField%1").arg(i));
-
-        // clear all visible user inputs
-        if(searchFieldBox && searchFieldBox->isVisible()) {
-
-            searchFieldBox->setCurrentIndex(nameIndex);
-            ui->scrollSearchContents->findChild<QComboBox *>(QString("scrollSearchRelation%1").arg(i))->setCurrentIndex(0);
-            ui->scrollSearchContents->findChild<QLineEdit *>(QString("scrollSearchInput%1").arg(i))->clear();
-        }
+    ui->searchTimeBox->setCurrentIndex(0);
+    // clear all user inputs
+    for(int i = 0; i < searchRows.size(); i++) {
+        searchRows.at(i)->reset(nameIndex);
     }
 }
 
@@ -559,14 +765,15 @@ void MainWindow::tableViewSelectionModel_currentRowChanged(const QModelIndex &cu
     Q_UNUSED(previous)
 
     enableModify();
+    updateDetailPane();
 }
 
 
 /*!
  * \brief Custom singal on resized column
  *
- * This signal adapts the height of the rows so the content is still entirely visible.
- * It also saves the layout of the current tableview to settings
+ * This signal saves the layout of the current tableview to settings.
+ * The height of the rows is adapted separately by the LazyRowSizer.
  *
  * \warning The arguments \a logicalIndex, \a oldSize and \a newSize are unused
  */
@@ -575,12 +782,73 @@ void MainWindow::tableView_headerResized(int logicalIndex, int oldSize, int newS
     Q_UNUSED(logicalIndex)
     Q_UNUSED(oldSize)
     Q_UNUSED(newSize)
-    ui->viewTable->resizeRowsToContents();
     if(allowResize) {
         saveSizeViewColumns();
     }
 }
 
+/*!
+ * \brief Shows the entries linked to the selected entry by transfers
+ *
+ * For a course the modules it is transferred to are listed, for a module the courses transferred to it
+ * and for a transfer its course and module. Each linked entry is shown with its own number of transfers.
+ * The entries are taken from the \l TransferGraph of the database, so no query is needed.
+ *
+ * \since 3.3
+ */
+void MainWindow::updateDetailPane()
+{
+    ui->detailTree->clear();
+    QString view = getCurrentView();
+    QString id = getSelectedId();
+    if(id.isEmpty() || !(view == "Kurse" || view == "Module" || view == "Anerkennungen")) {
+        ui->detailLabel->setText(tr("Select a course, module or transfer to see its linked entries."));
+        return;
+    }
+
+    const TransferGraph &graph = db.getTransferGraph();
+    ui->detailTree->setSortingEnabled(false);
+    if(view == "Kurse") {
+        QVector<int> modules = graph.modulesOf(id.toInt());
+        ui->detailLabel->setText(tr("The course is transferred to %1 modules.").arg(modules.size()));
+        for(int i = 0; i < modules.size(); i++) {
+            TransferGraph::Entry entry = graph.module(modules.at(i));
+            addDetailItem(entry.name, entry, graph.courseCount(modules.at(i)));
+        }
+    } else if(view == "Module") {
+        QVector<int> courses = graph.coursesOf(id.toInt());
+        ui->detailLabel->setText(tr("%1 courses are transferred to the module.").arg(courses.size()));
+        for(int i = 0; i < courses.size(); i++) {
+            TransferGraph::Entry entry = graph.course(courses.at(i));
+            addDetailItem(entry.name, entry, graph.moduleCount(courses.at(i)));
+        }
+    } else {
+        int course, module;
+        if(graph.transfer(id.toInt(), course, module)) {
+            ui->detailLabel->setText(tr("Course and module of the transfer"));
+            TransferGraph::Entry entry = graph.course(course);
+            addDetailItem(tr("Course: %1").arg(entry.name), entry, graph.moduleCount(course));
+            entry = graph.module(module);
+            addDetailItem(tr("Module: %1").arg(entry.name), entry, graph.courseCount(module));
+        }
+    }
+    ui->detailTree->setSortingEnabled(true);
+    ui->detailTree->resizeColumnToContents(0);
+}
+
+/*!
+ * \brief Adds a linked entry of name \a name and the ECTS of \a entry with \a transfers transfers to the detail pane
+ *
+ * \since 3.3
+ */
+void MainWindow::addDetailItem(const QString &name, const TransferGraph::Entry &entry, int transfers)
+{
+    QTreeWidgetItem *item = new QTreeWidgetItem(ui->detailTree);
+    item->setText(0, name);
+    item->setText(1, entry.ects);
+    item->setData(2, Qt::DisplayRole, transfers);
+}
+
 /*!
  * \brief Returns the database ID of a selected entry
  *
@@ -592,9 +860,9 @@ QString MainWindow::getSelectedId() const
 {
     if(!ui->viewTable->selectionModel()) return QString();
 
-    QModelIndex qidx = qsfpm->mapToSource(ui->viewTable->selectionModel()->currentIndex());
+    QModelIndex qidx = ui->viewTable->selectionModel()->currentIndex();
     if(qidx.isValid() && (ididx > -1)) {
-        return qsfpm->sourceModel()->data(qsfpm->sourceModel()->index(qidx.row(),ididx)).toString();
+        return tableModel->data(tableModel->index(qidx.row(), ididx)).toString();
     }
     return QString();
 }
@@ -610,7 +878,7 @@ QSqlQuery MainWindow::getSelectedQuery()
     QString id = getSelectedId();
 
     if(!id.isEmpty()) {
-        return (db.executeQuery(getCurrentView(), QStringList("ID ="), QStringList(id)));
+        return (db.executeQuery(Database::displayTable(getCurrentView()), SearchFilter::condition("ID", SearchFilter::Equals, id)));
     }
     return QSqlQuery();
 }
@@ -625,16 +893,141 @@ bool MainWindow::isReadonly(const QString &view)
     return (QString("anerkmodule").compare(view) == 0) || (QString("anerkkurse").compare(view) == 0);
 }
 
+/*!
+ * \brief Returns the report mode
+ *
+ * If \a view corresponds to a database view listing the results of a consistency check,
+ * this function returns \c true, and otherwise \c false.
+ * In contrast to the read-only views, all entries are listed at once.
+ *
+ * \since 3.3
+ */
+bool MainWindow::isReport(const QString &view)
+{
+    return (QString("ectsabweichungen").compare(view) == 0);
+}
+
+/*!
+ * \brief Returns if the entries of \a view can be restricted to a time range
+ *
+ * This is the case for the courses, modules and transfers, whose times of creation and of the last modification are stored.
+ *
+ * \since 3.3
+ */
+bool MainWindow::hasTimes(const QString &view)
+{
+    return view == "Kurse" || view == "Module" || view == "Anerkennungen";
+}
+
+/*!
+ * \brief Returns the search condition \a op with \a time on a time of the entries of \a view
+ *
+ * \a field is the column \tt Zeit or \tt Erstellt.
+ * As the views of the courses and modules only show the formatted time, their entries are found
+ * by the indexed column of the table in a subquery.
+ *
+ * \since 3.3
+ */
+SearchFilter MainWindow::timeCondition(const QString &view, const QString &field, SearchFilter::Operator op, qint64 time) const
+{
+    if(view == "Anerkennungen") {
+        return SearchFilter::condition("A." + field, op, time);
+    }
+    return SearchFilter::condition(field, op, time, view);
+}
+
+/*!
+ * \brief Returns the search condition for names of \a view similar to \a text
+ *
+ * \a field is the column of the names of the courses or modules. The entries are found by the
+ * fuzzy matcher of the database, the best \c max_similar of them are restricted by their IDs.
+ * If more names are similar, \a truncated is set to \c true, so the user can be told.
+ * On other columns the condition falls back to \e contains.
+ *
+ * \since 3.3
+ * \sa FuzzyMatcher
+ */
+SearchFilter MainWindow::similarCondition(const QString &view, const QString &field, const QString &text, bool *truncated)
+{
+    QString table, idField = "ID";
+    if(field == "K.Kursname") {
+        table = "Kurse";
+        idField = "K.ID";
+    } else if(field == "M.Modulname") {
+        table = "Module";
+        idField = "M.ID";
+    } else if(view == "Kurse" && field == "Kursname") {
+        table = "Kurse";
+    } else if(view == "Module" && field == "Modulname") {
+        table = "Module";
+    }
+    if(table.isEmpty() || text.trimmed().isEmpty()) {
+        return SearchFilter::condition(field, SearchFilter::Similar, text);
+    }
+
+    // one more than needed tells whether there are more
+    QList<FuzzyMatcher::Match> matches = db.getFuzzyMatcher(table).search(text, max_similar + 1);
+    if(matches.size() > max_similar) {
+        matches.removeLast();
+        if(truncated) *truncated = true;
+    }
+    QList<int> ids;
+    for(int i = 0; i < matches.size(); i++) {
+        ids << matches.at(i).id;
+    }
+    return SearchFilter::oneOf(idField, ids);
+}
+
+/*!
+ * \brief Returns the first day of the semester containing \a date
+ *
+ * The summer term lasts from April to September, the winter term from October to March.
+ *
+ * \since 3.3
+ */
+QDate MainWindow::semesterStart(const QDate &date)
+{
+    if(date.month() >= 10) {
+        return QDate(date.year(), 10, 1);
+    }
+    if(date.month() >= 4) {
+        return QDate(date.year(), 4, 1);
+    }
+    return QDate(date.year() - 1, 10, 1);
+}
+
+/*!
+ * \brief Returns the first day of the semester following the one starting at \a start
+ *
+ * \since 3.3
+ */
+QDate MainWindow::nextSemester(const QDate &start)
+{
+    return semesterStart(start.addMonths(6));
+}
+
+/*!
+ * \brief Returns the beginning of the day \a date in local time as seconds since the epoch
+ *
+ * \since 3.3
+ * \sa Database::currentEpoch()
+ */
+qint64 MainWindow::toEpoch(const QDate &date)
+{
+    return QDateTime(date, QTime(0, 0)).toMSecsSinceEpoch() / 1000;
+}
+
 /*!
  * \brief Returns if adding is allowed
  *
- * The addition is allowed if the current view is neither empty nor read only.
+ * The addition is allowed if the database is no read-only snapshot and
+ * the current view is neither empty nor read only nor a report.
  * In this case \c true is returned, otherwise \c false.
  */
 bool MainWindow::isAddAllowed()
 {
     QString view = getCurrentView();
-    return (!view.isEmpty() && !isReadonly(view));
+    return (!db.isReadOnly() && !view.isEmpty() && !isReadonly(view) && !isReport(view));
 }
 
 /*!
@@ -654,14 +1047,15 @@ bool MainWindow::isEditAllowed()
 /*!
  * \brief Returns if deleting is allowed
  *
- * The deletion is not allowed if the current view is empty or read only or no entry is selected.
+ * The deletion is not allowed if the database is a read-only snapshot,
+ * if the current view is empty or read only or no entry is selected.
  * Furthermore the deletion of courses or modules is prohibited if they are used within transfers.
  * If deletion is allowed \c true is returned, otherwise \c false.
  */
 bool MainWindow::isDeleteAllowed()
 {
     QString view = getCurrentView();
-    if(view.isEmpty() || getSelectedId().isEmpty() || isReadonly(view)) {
+    if(db.isReadOnly() || view.isEmpty() || getSelectedId().isEmpty() || isReadonly(view)) {
         return false;
     }
     // Course/Module is used in transfers?
@@ -678,144 +1072,137 @@ bool MainWindow::isDeleteAllowed()
 }
 
 /*!
- * \brief Adds a search condition row
+ * \brief Creates a search condition row and inserts it into the search area below the row \a after
+ *
+ * Without \a after the row is appended after the last one.
+ * The row offers the columns of the current view and has the column containing "name" selected.
  *
- * A hidden search condition row is taken from the top of the search stack and displayed.
- * If it was the last all add buttons are disabled
+ * \since 3.3
  */
-void MainWindow::searchConditionAdd()
+SearchRow *MainWindow::createSearchRow(SearchRow *after)
 {
-    QLayout *layout = ui->scrollSearchContents->layout();
-
-    // Take the top element from the stack and add it to the layout.
-    if(!searchWidgetStack->isEmpty()) {
-        QLayoutItem *item = searchWidgetStack->pop();
-        // Beware! Last item is a spacer
-        QLayoutItem *spacer = layout->takeAt(layout->count()-1);
-        layout->addItem(item);
-        layout->addItem(spacer);
-        item->widget()->show();
-    }
-
-    // if stack is empty after taking the top element, disable all add buttons
-    if(searchWidgetStack->isEmpty()) {
-        for(int i=0; i < max_search; i++) {
-            QPushButton *searchAddButtonGen = ui->scrollSearchContents->findChild<QPushButton *>(QString("scrollSearchAdd%1").arg(i));
-            if(searchAddButtonGen) searchAddButtonGen->setEnabled(false);
-        }
-    }
-
-    // If there had been only one row previously, enable its remove button
-    // layout =3 : old row + new row + spacer
-    if(layout->count() == 3) {
-        QPushButton *searchRemoveButtonFirst = ui->scrollSearchContents->findChild<QPushButton *>(QString("scrollSearchRemove%1").arg(layout->itemAt(0)->widget()->objectName().right(1)));
-        if(searchRemoveButtonFirst) searchRemoveButtonFirst->setEnabled(true);
+    SearchRow *row = new SearchRow(ui->scrollSearchContents);
+    row->setFields(searchFields);
+    row->reset(nameIndex);
+    connect(row, SIGNAL(addRequested(SearchRow*)), this, SLOT(searchConditionAdd(SearchRow*)));
+    connect(row, SIGNAL(removeRequested(SearchRow*)), this, SLOT(searchConditionRemove(SearchRow*)));
+
+    // Beware! Last item is a spacer
+    QVBoxLayout *layout = qobject_cast<QVBoxLayout *>(ui->scrollSearchContents->layout());
+    int index = searchRows.indexOf(after);
+    if(index < 0) {
+        index = searchRows.size() - 1;
     }
+    layout->insertWidget(index + 1, row);
+    searchRows.insert(index + 1, row);
+    return row;
 }
 
 /*!
- * \brief Removes a search condition row
+ * \brief Enables the remove buttons of the search condition rows unless only a single one is left
  *
- * A visible search condition row is cleared and put on top of the search stack and hidden.
- * If only one row remains visible its remove buttons is disabled.
- * If all add buttons were disabled, it enables them now.
+ * \since 3.3
  */
-void MainWindow::searchConditionRemove()
+void MainWindow::enableSearchRemove()
 {
-    QLayout *layout = ui->scrollSearchContents->layout();
-
-    QPushButton* button = qobject_cast<QPushButton*>(sender());
-    QString id = button->objectName().right(1);
-
-    QWidget *widget = ui->scrollSearchContents->findChild<QWidget *>(QString("scrollSearchWidget%1").arg(id));
-    if(widget) {
-
-        // Remove the search condition row from the layout and put on stack
-        for(int i = 0; i < layout->count(); i++) {
-            if(layout->itemAt(i)->widget() == widget) {
-                searchWidgetStack->push(layout->takeAt(i));
-                break;
-            }
-        }
-        // Hide the search condition row
-        widget->hide();
-
-        // If only one search condition row is visible , disable the remove button
-        if(layout->count() == 2) {
-            QPushButton *searchRemoveButtonFirst = ui->scrollSearchContents->findChild<QPushButton *>(QString("scrollSearchRemove%1").arg(layout->itemAt(0)->widget()->objectName().right(1)));
-            if(searchRemoveButtonFirst) searchRemoveButtonFirst->setEnabled(false);
-        }
-    }
-
-    // Enable all add buttons again if they were previously disabled
-    if(searchWidgetStack->size() == 1) {
-        for(int i=0; i < max_search; i++) {
-            QPushButton *searchAddButtonGen = ui->scrollSearchContents->findChild<QPushButton *>(QString("scrollSearchAdd%1").arg(i));
-            if(searchAddButtonGen) searchAddButtonGen->setEnabled(true);
-        }
+    for(int i = 0; i < searchRows.size(); i++) {
+        searchRows.at(i)->setRemovable(searchRows.size() > 1);
     }
+}
 
-    // Clear / set to default all contents of the hidden search condition row
-    QComboBox *searchFieldBox = ui->scrollSearchContents->findChild<QComboBox *>(QString("scrollSearchField%1").arg(id));
-    if(searchFieldBox) searchFieldBox->setCurrentIndex(nameIndex);
-
-    QComboBox *searchRelationBox = ui->scrollSearchContents->findChild<QComboBox *>(QString("scrollSearchRelation%1").arg(id));
-    if(searchRelationBox) searchRelationBox->setCurrentIndex(0);
+/*!
+ * \brief Adds a search condition row
+ *
+ * A new search condition row is displayed below \a row, whose add button has been clicked.
+ * There is no limit on the number of rows.
+ */
+void MainWindow::searchConditionAdd(SearchRow *row)
+{
+    createSearchRow(row);
+    enableSearchRemove();
+}
 
-    QLineEdit *searchInputLine = ui->scrollSearchContents->findChild<QLineEdit *>(QString("scrollSearchInput%1").arg(id));
-    if(searchInputLine) searchInputLine->clear();
+/*!
+ * \brief Removes the search condition row \a row
+ *
+ * If only one row remains, its remove button is disabled.
+ */
+void MainWindow::searchConditionRemove(SearchRow *row)
+{
+    if(searchRows.size() < 2 || !searchRows.removeOne(row)) return;
 
+    ui->scrollSearchContents->layout()->removeWidget(row);
+    row->deleteLater();
+    enableSearchRemove();
 }
 
 /*!
  * \brief The search button is clicked
  *
  * A search is initiated.
- * The visible search conditions are processed and used as restrictions for the call to \l MainWindow::adjustModel().
+ * The search conditions are combined into a single \l SearchFilter, which is used as restriction for the call to \l MainWindow::adjustModel().
+ * A time restriction is added to them, which is always required, even if any of the conditions is to match.
  * Additionally, the member variable indicating as search has happened is set to \c true.
  */
 void MainWindow::on_searchButtonsSearch_clicked()
 {
     // How to link the conditions?
     bool conditionOr = (!ui->searchModeAllButton->isChecked()) && (ui->searchModeAnyButton->isChecked());
-    QStringList conditionCols, conditionVals, relations;
-
-    // create the restriction rules for adjustModel call based on the inputs
-    for(unsigned int i = 0; i < max_search; i++) {
-
-        QComboBox *searchFieldBox = ui->scrollSearchContents->findChild<QComboBox *>(QString("scrollSearchField%1").arg(i));
-
-        // Only process visible search condition rows
-        if(searchFieldBox && searchFieldBox->isVisible()) {
-
-            QComboBox *searchRelationBox = ui->scrollSearchContents->findChild<QComboBox *>(QString("scrollSearchRelation%1").arg(i));
-            QLineEdit *searchInputLine = ui->scrollSearchContents->findChild<QLineEdit *>(QString("scrollSearchInput%1").arg(i));
-
-            // Escape special SQL characters
-            QString input = searchInputLine->text().replace("!", "!!")
-                    .replace("%", "!%")
-                    .replace("_", "!_")
-                    .replace("[", "![");
-
-            // wrap like clauses in placeholders
-            QString relation = searchRelationBox->currentData().toString();
-            if(relation.contains("LIKE")) {
-                input = "%" + input + "%";
-            }
-
-            conditionCols << (searchFieldBox->currentData().toString() + relation);
-            conditionVals << input;
-            if(i>0) {
-                relations << (conditionOr ? " OR " : " AND ");
-            }
+    QList<SearchFilter> conditions;
+    bool truncated = false;
+    for(int i = 0; i < searchRows.size(); i++) {
+        const SearchRow *row = searchRows.at(i);
+        // rows without a field do not restrict the search, not even when any condition is to match
+        if(row->field().isEmpty()) {
+            continue;
+        }
+        if(row->relation() == SearchFilter::Similar) {
+            conditions << similarCondition(getCurrentView(), row->field(), row->text(), &truncated);
+        } else {
+            conditions << row->filter();
         }
     }
 
+    // the time restriction is compared with the indexed times in seconds since the epoch
+    QString view = getCurrentView();
+    QString timeFilter = ui->searchTimeBox->currentData().toString();
+    QList<SearchFilter> restrictions;
+    if(hasTimes(view) && timeFilter == "changed") {
+        restrictions << timeCondition(view, "Zeit", SearchFilter::AtLeast, toEpoch(ui->searchTimeDate->date()));
+    } else if(hasTimes(view) && timeFilter == "semester") {
+        QDate start = ui->searchSemesterBox->currentData().toDate();
+        restrictions << timeCondition(view, "Erstellt", SearchFilter::AtLeast, toEpoch(start))
+                     << timeCondition(view, "Erstellt", SearchFilter::Below, toEpoch(nextSemester(start)));
+    }
+    restrictions << SearchFilter::group(conditionOr ? SearchFilter::Any : SearchFilter::All, conditions);
+
     // set member for search to true
     hasSearched = true;
 
     // adjust the table view
-    adjustModel(getCurrentView(), conditionCols, conditionVals, relations);
+    adjustModel(view, SearchFilter::all(restrictions));
+
+    // the message of adjustModel() is extended, so that the cut of the similar names is not overlooked
+    if(truncated) {
+        QString message = tr("Only the %1 names most similar to the searched text are considered.").arg(max_similar);
+        QString current = statusBar()->currentMessage();
+        statusBar()->showMessage(current.isEmpty() ? message : current + " " + message, 10000);
+    }
+}
+
+/*!
+ * \brief The kind of time restriction of the search is changed to the one of index \a index
+ *
+ * Only the input belonging to the time restriction is shown: the date for entries changed since then
+ * or the semester for entries created within it.
+ *
+ * \since 3.3
+ */
+void MainWindow::on_searchTimeBox_currentIndexChanged(int index)
+{
+    QString timeFilter = ui->searchTimeBox->itemData(index).toString();
+    ui->searchTimeDate->setVisible(timeFilter == "changed");
+    ui->searchSemesterBox->setVisible(timeFilter == "semester");
 }
 
 /*!
@@ -884,6 +1271,7 @@ void MainWindow::on_editButtonsModify_clicked()
 
     // preset values in dialog with database entry of selected value
     dialog->presetValues(getSelectedQuery());
+    dialog->setNameIndex(&db.getNameIndex(view), getSelectedId().toInt());
 
     if(dialog->exec() == QDialog::Accepted ) {
         // update the entry in database
@@ -923,11 +1311,12 @@ void MainWindow::on_editButtonsAdd_clicked()
         TransferAddDialog *dialog = new TransferAddDialog(&db, this);
 
         if(dialog->exec() == QDialog::Accepted) {
-            // Insert values into database
-            QStringList colList, valList;
+            // Insert all transfers at once into database
+            QStringList colList;
             colList << "KID" << "MID";
-            valList << dialog->getCid() << dialog->getMid();
-            db.insertEntry(view, colList, valList);
+            if(db.insertEntries(view, colList, dialog->getTransfers()) < 0) {
+                QMessageBox::warning(this, tr("Add Transfers"), tr("The transfers could not be added to the database. None of them has been saved."));
+            }
             adjustModel(view);
         }
         delete dialog;
@@ -935,6 +1324,7 @@ void MainWindow::on_editButtonsAdd_clicked()
     } else {
 
         ModifyDialog *dialog = new ModifyDialog(view, this, true);
+        dialog->setNameIndex(&db.getNameIndex(view));
 
         if(dialog->exec() == QDialog::Accepted ) {
             // Insert values into database
@@ -1050,10 +1440,126 @@ void MainWindow::on_readonlyComboBox_currentIndexChanged(int index)
 {
 
     if(index > -1) {
-        QModelIndex qidx = readonlyProxy->mapToSource(ui->readonlyComboBox->model()->index(index,0));
-        readonlyId = readonlyProxy->sourceModel()->data(qidx).toString();
+        QAbstractItemModel *model = ui->readonlyComboBox->model();
+        readonlyId = model->data(model->index(index,0)).toString();
+        // Stepping onto the last fetched entry loads the next portion, so stepping can continue
+        if((index == model->rowCount() - 1) && model->canFetchMore(QModelIndex())) {
+            model->fetchMore(QModelIndex());
+        }
         adjustModel(getCurrentView());
         enablePrint();
+        prefetchNeighbours(index);
+    }
+}
+
+/*!
+ * \brief Requests the transfers of the entries next to \a index in the read-only combobox
+ *
+ * The transfers of the previous and next \c max_prefetch entries are fetched in the background by the \l TransferPrefetcher,
+ * so that stepping through the entries does not need to wait for the database.
+ * They are stored in the query cache of the database, see \l Database::fetchTable(),
+ * which discards them after the data of the database changed.
+ * Nothing is prefetched for an in-memory working copy, which answers the queries fast enough.
+ *
+ * \since 3.3
+ */
+void MainWindow::prefetchNeighbours(int index)
+{
+    // The prefetcher reads the database file, which lags behind an in-memory working copy
+    if(db.isInMemory()) return;
+
+    if(prefetchVersion != db.dataVersion()) {
+        prefetchPending.clear();
+        prefetchVersion = db.dataVersion();
+    }
+
+    QString view = getCurrentView();
+    QAbstractItemModel *model = ui->readonlyComboBox->model();
+    QStringList ids;
+    int last = qMin(model->rowCount() - 1, index + max_prefetch);
+    for(int i = qMax(0, index - max_prefetch); i <= last; i++) {
+        QString id = model->data(model->index(i, 0)).toString();
+        QString key = view + ":" + id;
+        // the same restriction as the one of adjustModel() for a single entry
+        if(i != index && !prefetchPending.contains(key)
+                && !db.isCached(view, SearchFilter::condition("ID", SearchFilter::Equals, id), "*")) {
+            ids << id;
+            prefetchPending.insert(key);
+        }
+    }
+
+    if(!ids.isEmpty()) {
+        emit prefetchRequested(db.isReadOnly() ? db.getSnapshotUri() : db.getDBFilePath(), view, ids, prefetchVersion);
+    }
+}
+
+/*!
+ * \brief Stores the prefetched transfers \a records of entry \a id of the read-only view \a view
+ *
+ * The field names are given by \a header.
+ * Results requested for another data version than \a version, the current one, are discarded.
+ *
+ * \since 3.3
+ */
+void MainWindow::neighbourPrefetched(const QString &view, const QString &id, int version, const QSqlRecord &header, const QVector<QSqlRecord> &records)
+{
+    if(version != prefetchVersion || version != db.dataVersion()) return;
+
+    prefetchPending.remove(view + ":" + id);
+    db.cacheRecords(view, SearchFilter::condition("ID", SearchFilter::Equals, id), "*", version, header, records);
+}
+
+/*!
+ * \brief The transfers of the entries \a ids of the read-only view \a view could not be prefetched
+ *
+ * The entries are no longer pending, so that they are requested again when they come close to the displayed entry.
+ * Failures of requests for another data version than \a version, the current one, are ignored,
+ * as the pending entries have been discarded with the change of the version.
+ *
+ * \since 3.3
+ */
+void MainWindow::neighbourPrefetchFailed(const QString &view, const QStringList &ids, int version)
+{
+    if(version != prefetchVersion) return;
+
+    for(int i = 0; i < ids.size(); i++) {
+        prefetchPending.remove(view + ":" + ids.at(i));
+    }
+}
+
+/*!
+ * \brief The text of the filter for the read-only combobox was edited to \a text
+ *
+ * The combobox is filled with the entries whose name starts with \a text.
+ * If the currently displayed entry is still among the first fetched ones, it stays selected,
+ * otherwise the view is emptied.
+ *
+ * \since 3.3
+ */
+void MainWindow::on_readonlyFilterEdit_textEdited(const QString &text)
+{
+    Q_UNUSED(text)
+
+    QString view = getCurrentView();
+    if(!isReadonly(view)) return;
+
+    LookupModel *model = selectorModel(view);
+    int row = -1;
+    for(int i = 0; i < model->rowCount() && !readonlyId.isEmpty(); i++) {
+        if(model->data(model->index(i, 0)).toString() == readonlyId) {
+            row = i;
+            break;
+        }
+    }
+
+    ui->readonlyComboBox->blockSignals(true);
+    ui->readonlyComboBox->setCurrentIndex(row);
+    ui->readonlyComboBox->blockSignals(false);
+
+    if(row < 0 && !readonlyId.isEmpty()) {
+        readonlyId.clear();
+        resetViewAndSearch(true);
+        enablePrint();
     }
 }
 
@@ -1063,6 +1569,7 @@ void MainWindow::on_readonlyComboBox_currentIndexChanged(int index)
  * \fn MainWindow::on_actionModuleCourse_triggered()
  * \fn MainWindow::on_actionCourseModule_triggered()
  * \fn MainWindow::on_actionTransfers_triggered()
+ * \fn MainWindow::on_actionEctsDeviations_triggered()
  *
  * \brief Signals for the menu entries
  *
@@ -1093,6 +1600,11 @@ void MainWindow::on_actionTransfers_triggered()
     ui->viewComboBox->setCurrentIndex(4);
 }
 
+void MainWindow::on_actionEctsDeviations_triggered()
+{
+    ui->viewComboBox->setCurrentIndex(5);
+}
+
 /*!
  * \brief About menu entry
  *
@@ -1139,7 +1651,8 @@ void MainWindow::on_actionExportSqlite_triggered()
     // Overwrite any file of same name there!
     if(file.exists()) {file.remove();}
 
-    // Copy the current database file to the destination
+    // Copy the current database file to the destination (with all changes of an in-memory working copy)
+    db.flush();
     QFile::copy(db.getDBFilePath(),fileName);
     QMessageBox::information(this, tr("Database Export"), tr("Database has been successfully exported to SQLite."));
 }
@@ -1173,8 +1686,9 @@ void MainWindow::on_actionExportSinglecsv_triggered()
     // write the view of 'Anerkennungen' to CSV
     CSVWriter writer(&db, this);
 
-    QString mytable = "Module M JOIN Anerkennungen A ON M.ID = A.MID JOIN Kurse K ON K.ID = A.KID";
-    QString selectcols = "K.Kursname AS 'Kurs-Name', K.ECTS AS 'Kurs-ECTS', K.Herkunft AS 'Kurs-Herkunft', M.Modulname AS 'Modul-Name', M.ECTS AS 'Modul-ECTS', M.PO AS 'Modul-PO'";
+    QString mytable = "Module M JOIN Anerkennungen A ON M.ID = A.MID JOIN Kurse K ON K.ID = A.KID "
+                      "LEFT JOIN Herkunft H ON H.ID = K.HID LEFT JOIN PO P ON P.ID = M.POID";
+    QString selectcols = "K.Kursname AS 'Kurs-Name', K.ECTS AS 'Kurs-ECTS', H.Name AS 'Kurs-Herkunft', M.Modulname AS 'Modul-Name', M.ECTS AS 'Modul-ECTS', P.Name AS 'Modul-PO'";
 
     writer.writeCSV(file, mytable, selectcols);
 
@@ -1225,7 +1739,8 @@ void MainWindow::on_actionExportCsv_triggered()
     for(int i = 0; i< tables.size(); ++i) {
         table = tables.at(i);
         QFile tmpfile(tmpdirpath + "/" + table + ".csv");
-        writer.writeCSV(tmpfile, table);
+        // courses and modules with the names of their origins and POs
+        writer.writeCSV(tmpfile, Database::displayTable(table));
     }
 
     // pack the csv files into a zip archive
@@ -1233,6 +1748,221 @@ void MainWindow::on_actionExportCsv_triggered()
     QMessageBox::information(this, tr("Database Export"), tr("Database has been successfully exported to a zip-archive of CSV files."));
 }
 
+/*!
+ * \brief Export of changes to CSV menu entry
+ *
+ * Exports the entries of each table, which have been changed since the last export to the same file,
+ * into a single CSV file (in German format). The IDs of the entries deleted since then are written to the file
+ * \c Geloescht.csv, which is to be applied before the changed entries. All the CSV files are then packed into a ZIP archive.
+ *
+ * The time of each export is stored in the database for the absolute path of the file, see \l Database::exportWatermark().
+ * The first export to a file contains all entries. Entries changed in the second of the last export are exported again.
+ *
+ * \warning The export overwrites files of the same name without a warning to the user.
+ * \since 3.3
+ */
+void MainWindow::on_actionExportDelta_triggered()
+{
+    QStringList filefiltersZip;
+    filefiltersZip << tr("Zip-Archive (*.zip)") << tr("All files (*)");
+
+    // Dialog to get the destination file name
+    QString fileName = QFileDialog::getSaveFileName(this,
+            tr("Database Export"), QDir::homePath(),
+            filefiltersZip.join(";;"), &filefiltersZip.first());
+    // Do nothing if destination file name is empty
+    if(fileName.isEmpty()) return;
+
+    // Give it a proper file ending, if user hasn't specified
+    int lastsep = qMax(fileName.lastIndexOf("/"), fileName.lastIndexOf("\\"));
+    int lastpoint = fileName.lastIndexOf(".");
+    if(lastpoint <= lastsep) {
+        fileName.append(".zip");
+    }
+
+    // Create a temporary directory. If not possible do nothing and return
+    QTemporaryDir tmpdir;
+    if(!tmpdir.isValid()) {
+        qCritical() << tr("Unable to create temporary directory");
+        return;
+    }
+    CSVWriter writer(&db, this);
+
+    // the time is taken before reading, so changes during the export are exported again next time
+    QString target = QFileInfo(fileName).absoluteFilePath();
+    qint64 since = db.exportWatermark(target);
+    qint64 now = Database::currentEpoch();
+
+    QString tmpdirpath = tmpdir.path();
+    QStringList tables;
+    tables << "Kurse" << "Module" << "Anerkennungen";
+    QString table;
+    int changed = 0;
+    int deleted = 0;
+
+    // write the changed entries of each table to a csv file, found by the index on the time of modification
+    for(int i = 0; i < tables.size(); ++i) {
+        table = tables.at(i);
+        QFile tmpfile(tmpdirpath + "/" + table + ".csv");
+        SearchFilter filter;
+        if(since >= 0) {
+            filter = SearchFilter::condition("Zeit", SearchFilter::AtLeast, since, table);
+        }
+        int count = writer.writeCSV(tmpfile, Database::displayTable(table), "*", filter);
+        if(count < 0) return;
+        changed += count;
+    }
+
+    // write the deleted entries
+    if(since >= 0) {
+        QFile tmpfile(tmpdirpath + "/Geloescht.csv");
+        deleted = writer.writeCSV(tmpfile, "Geloescht", "Tabelle, Eintrag AS ID, datetime(Zeit, 'unixepoch', 'localtime') AS Datum",
+                                  SearchFilter::condition("Zeit", SearchFilter::AtLeast, since));
+        if(deleted < 0) return;
+    }
+
+    // pack the csv files into a zip archive and only then remember the time of the export
+    if(!JlCompress::compressDir(fileName, tmpdirpath)) {
+        QMessageBox::warning(this, tr("Database Export"), tr("Unable to write the zip-archive '%1'.").arg(fileName));
+        return;
+    }
+    db.setExportWatermark(target, now);
+
+    if(since < 0) {
+        QMessageBox::information(this, tr("Database Export"), tr("This is the first export to this file, so all %1 entries have been exported.").arg(changed));
+    } else {
+        QMessageBox::information(this, tr("Database Export"), tr("%1 changed and %2 deleted entries since %3 have been exported.")
+                                 .arg(changed).arg(deleted).arg(QDateTime::fromMSecsSinceEpoch(since * 1000).toString("yyyy-MM-dd hh:mm:ss")));
+    }
+}
+
+
+/*!
+ * \brief Export of a changeset menu entry
+ *
+ * Asks for the time since when the changes are to be exported, which defaults to the time of the last export of a changeset.
+ * That time is stored in the database, the change log is pruned up to it (see \l Database::setExportWatermark()).
+ * The changes are then written into a changeset file, see \l ChangeSet, which can be applied to another copy of the database.
+ *
+ * \warning The export overwrites files of the same name without a warning to the user.
+ * \since 3.3
+ */
+void MainWindow::on_actionExportChanges_triggered()
+{
+    qint64 lastExport = db.exportWatermark(changeset_target);
+    QDateTime sinceTime = lastExport > -1 ? QDateTime::fromMSecsSinceEpoch(lastExport * 1000)
+                                          : QDateTime(QDate::currentDate().addMonths(-1), QTime(0, 0));
+
+    // Dialog to get the time since when the changes are exported
+    QDialog sinceDialog(this);
+    sinceDialog.setWindowTitle(tr("Changeset Export"));
+    QFormLayout *layout = new QFormLayout(&sinceDialog);
+    QDateTimeEdit *sinceEdit = new QDateTimeEdit(sinceTime, &sinceDialog);
+    sinceEdit->setCalendarPopup(true);
+    sinceEdit->setDisplayFormat("dd.MM.yyyy hh:mm");
+    layout->addRow(tr("Changes since:"), sinceEdit);
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &sinceDialog);
+    connect(buttons, SIGNAL(accepted()), &sinceDialog, SLOT(accept()));
+    connect(buttons, SIGNAL(rejected()), &sinceDialog, SLOT(reject()));
+    layout->addRow(buttons);
+    if(sinceDialog.exec() != QDialog::Accepted) return;
+
+    // Dialog to get the destination file name
+    QString fileName = QFileDialog::getSaveFileName(this,
+            tr("Changeset Export"), QDir::homePath(),
+            filefiltersChangeset.join(";;"), &filefiltersChangeset.first());
+    // Do nothing if destination file name is empty
+    if(fileName.isEmpty()) return;
+
+    // Give it a proper file ending, if user hasn't specified
+    int lastsep = qMax(fileName.lastIndexOf("/"), fileName.lastIndexOf("\\"));
+    int lastpoint = fileName.lastIndexOf(".");
+    if(lastpoint <= lastsep) {
+        fileName.append(".changeset");
+    }
+
+    qint64 now = Database::currentEpoch();
+    ChangeSet changeSet(&db);
+    if(!changeSet.exportChanges(fileName, sinceEdit->dateTime().toMSecsSinceEpoch() / 1000)) {
+        QMessageBox::warning(this, tr("Changeset Export"), tr("The changes could not be exported: %1").arg(changeSet.lastError()));
+        return;
+    }
+    db.setExportWatermark(changeset_target, now);
+    QMessageBox::information(this, tr("Changeset Export"), tr("%1 changed and %2 deleted entries have been exported.")
+                             .arg(changeSet.changedEntries()).arg(changeSet.deletedEntries()));
+}
+
+/*!
+ * \brief Export to binary dump menu entry
+ *
+ * Exports the whole database into a compact binary dump at the user specified location, see \l BinaryDump.
+ *
+ * \warning The export overwrites files of the same name without a warning to the user.
+ *
+ * \since 3.3
+ */
+void MainWindow::on_actionExportDump_triggered()
+{
+    // Dialog to get the destination file name
+    QString fileName = QFileDialog::getSaveFileName(this,
+            tr("Binary Dump Export"), QDir::homePath(),
+            filefiltersDump.join(";;"), &filefiltersDump.first());
+    // Do nothing if destination file name is empty
+    if(fileName.isEmpty()) return;
+
+    // Give it a proper file ending, if user hasn't specified
+    int lastsep = qMax(fileName.lastIndexOf("/"), fileName.lastIndexOf("\\"));
+    int lastpoint = fileName.lastIndexOf(".");
+    if(lastpoint <= lastsep) {
+        fileName.append(".adbdump");
+    }
+
+    BinaryDump dump(QSqlDatabase::database());
+    if(!dump.write(fileName)) {
+        QMessageBox::warning(this, tr("Binary Dump Export"), tr("The database could not be exported: %1").arg(dump.lastError()));
+        return;
+    }
+    QMessageBox::information(this, tr("Binary Dump Export"), tr("%1 entries have been exported.").arg(dump.entryCount()));
+}
+
+/*!
+ * \brief Apply changeset menu entry
+ *
+ * Applies the changes of a selected changeset file, see \l ChangeSet.
+ * The entries which have not been taken over are listed in the details of the final message.
+ *
+ * \since 3.3
+ */
+void MainWindow::on_actionApplyChanges_triggered()
+{
+    // Dialog to get the file name of the changeset
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Apply Changeset"), QDir::homePath(),
+                                                    filefiltersChangeset.join(";;"), &filefiltersChangeset.first());
+    // Do nothing if file name is empty
+    if(fileName.isEmpty()) return;
+
+    ChangeSet changeSet(&db);
+    bool success = changeSet.apply(fileName);
+    if(changeSet.changedEntries() + changeSet.deletedEntries() > 0) {
+        clearSelectorModels();
+        refreshView();
+    }
+    if(!success) {
+        QMessageBox::warning(this, tr("Apply Changeset"), tr("The changeset could not be applied: %1").arg(changeSet.lastError()));
+        return;
+    }
+
+    QMessageBox message(QMessageBox::Information, tr("Apply Changeset"),
+                        tr("%1 changed and %2 deleted entries have been taken over.")
+                        .arg(changeSet.changedEntries()).arg(changeSet.deletedEntries()), QMessageBox::Ok, this);
+    QStringList conflicts = changeSet.conflicts();
+    if(!conflicts.isEmpty()) {
+        message.setIcon(QMessageBox::Warning);
+        message.setInformativeText(tr("%1 entries have been kept as they are, see the details.").arg(conflicts.size()));
+        message.setDetailedText(conflicts.join("\n"));
+    }
+    message.exec();
+}
 
 /*!
  * \brief Import SQLite menu entry
@@ -1264,7 +1994,9 @@ void MainWindow::on_actionRestore_triggered()
     // set the view combobox empty
     ui->viewComboBox->setCurrentIndex(-1);
 
-    // Close the current database
+    // Close the current database and the connection of the prefetcher
+    clearSelectorModels();
+    QMetaObject::invokeMethod(prefetcher, "closeDatabase", Qt::BlockingQueuedConnection);
     db.closeDatabase();
     // Copy the database to import over the current database
     QFile dbFile(db.getDBFilePath());
@@ -1272,9 +2004,74 @@ void MainWindow::on_actionRestore_triggered()
     QFile::copy(fileName, db.getDBFilePath());
     // Open the imported database
     db.openDatabase();
+    initPersistStatus();
     QMessageBox::information(this, tr("Database Import"), tr("Database was successfully imported."));
 }
 
+/*!
+ * \brief Import binary dump menu entry
+ *
+ * It replaces the database by the contents of a selected binary dump, see \l BinaryDump.
+ * The dump is first loaded into a new database file next to the current one,
+ * so the current database stays untouched if the dump cannot be loaded.
+ * Only then the current database is closed, replaced by the new file and opened again.
+ *
+ * \since 3.3
+ */
+void MainWindow::on_actionRestoreDump_triggered()
+{
+    // Dialog to get the file name of the dump to import
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Binary Dump Import"), QDir::homePath(),
+                                                    filefiltersDump.join(";;"), &filefiltersDump.first());
+    // Do nothing if file name is empty
+    if(fileName.isEmpty()) return;
+
+    // Load the dump into a new database file by a separate connection
+    QString restorePath = db.getDBFilePath() + ".restore";
+    QFile::remove(restorePath);
+    bool success = false;
+    QString error;
+    int entries = 0;
+    {
+        QSqlDatabase restoreDb = QSqlDatabase::addDatabase("QSQLITE", "binarydump");
+        restoreDb.setDatabaseName(restorePath);
+        if(restoreDb.open()) {
+            // The file is discarded anyway if anything goes wrong
+            QSqlQuery query(restoreDb);
+            query.exec("PRAGMA synchronous = OFF");
+            query.exec("PRAGMA journal_mode = MEMORY");
+            BinaryDump dump(restoreDb);
+            success = dump.read(fileName);
+            error = dump.lastError();
+            entries = dump.entryCount();
+            restoreDb.close();
+        } else {
+            error = restoreDb.lastError().text();
+        }
+    }
+    QSqlDatabase::removeDatabase("binarydump");
+    if(!success) {
+        QFile::remove(restorePath);
+        QMessageBox::warning(this, tr("Binary Dump Import"), tr("The binary dump could not be imported: %1").arg(error));
+        return;
+    }
+
+    // set the view combobox empty
+    ui->viewComboBox->setCurrentIndex(-1);
+
+    // Close the current database and the connection of the prefetcher
+    clearSelectorModels();
+    QMetaObject::invokeMethod(prefetcher, "closeDatabase", Qt::BlockingQueuedConnection);
+    db.closeDatabase();
+    // Replace the current database by the loaded one
+    QFile::remove(db.getDBFilePath());
+    QFile::rename(restorePath, db.getDBFilePath());
+    // Open the imported database
+    db.openDatabase();
+    initPersistStatus();
+    QMessageBox::information(this, tr("Binary Dump Import"), tr("%1 entries have been imported.").arg(entries));
+}
+
 /*!
  * \brief Print menu entry
  *
@@ -1295,7 +2092,7 @@ void MainWindow::on_actionPrint_triggered()
 void MainWindow::on_actionOptions_triggered()
 {
     ConfigManager::getInstance()->execConfigDialog(this);
-    ui->viewTable->resizeRowsToContents();
+    rowSizer->invalidate();
 }
 
 /*!
@@ -22,10 +22,13 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
-#define max_search 6
+#define max_prefetch 5
+#define change_poll_interval 2000
+#define max_semesters 20
+// Most entries found by a search for similar names (each is bound to a placeholder)
+#define max_similar 500
 
 #include <QMainWindow>
-#include <QStack>
 #include <QLayoutItem>
 #include <QtDebug>
 #include <QFileDialog>
@@ -33,6 +36,16 @@
 #include <QPrintPreviewDialog>
 #include <QtGlobal>
 #include <QStatusBar>
+#include <QLabel>
+#include <QTimer>
+#include <QStandardItemModel>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QTreeWidget>
+#include <QFormLayout>
+#include <QDateTimeEdit>
+#include <QDialogButtonBox>
 #include <JlCompress.h>
 #include "database.h"
 #include "modifydialog.h"
@@ -42,6 +55,15 @@
 #include "csvwriter.h"
 #include "tableprinter.h"
 #include "printlayout.h"
+#include "lazyrowsizer.h"
+#include "columnwidthestimator.h"
+#include "compacttablemodel.h"
+#include "lookupmodel.h"
+#include "transferprefetcher.h"
+#include "changeset.h"
+#include "binarydump.h"
+#include "searchfilter.h"
+#include "searchrow.h"
 
 namespace Ui {
 class MainWindow;
@@ -63,10 +85,11 @@ protected:
 
 private slots:
 
-    void searchConditionAdd();
-    void searchConditionRemove();
+    void searchConditionAdd(SearchRow *row);
+    void searchConditionRemove(SearchRow *row);
     void on_searchButtonsSearch_clicked();
     void on_searchButtonsReset_clicked();
+    void on_searchTimeBox_currentIndexChanged(int index);
 
     void on_viewComboBox_currentIndexChanged(int index);
 
@@ -83,32 +106,76 @@ private slots:
     void on_actionCourseModule_triggered();
     void on_actionTransfers_triggered();
 
+    void on_actionEctsDeviations_triggered();
+
     void on_actionAbout_triggered();
 
     void on_actionExportSqlite_triggered();
     void on_actionExportSinglecsv_triggered();
     void on_actionExportCsv_triggered();
+    void on_actionExportDelta_triggered();
+    void on_actionExportChanges_triggered();
+    void on_actionExportDump_triggered();
 
     void on_actionRestore_triggered();
+    void on_actionApplyChanges_triggered();
+    void on_actionRestoreDump_triggered();
 
     void print(QPrinter *printer);
     void on_actionPrint_triggered();
 
     void on_readonlyComboBox_currentIndexChanged(int index);
 
+    void on_readonlyFilterEdit_textEdited(const QString &text);
+
     void on_actionOptions_triggered();
 
+    void updatePersistStatus();
+
+    void pollExternalChanges();
+
+    void neighbourPrefetched(const QString &view, const QString &id, int version, const QSqlRecord &header, const QVector<QSqlRecord> &records);
+    void neighbourPrefetchFailed(const QString &view, const QStringList &ids, int version);
+
+signals:
+    void prefetchRequested(const QString &databasePath, const QString &view, const QStringList &ids, int version);
+
 private:
     Ui::MainWindow *ui;
 
     Database db;
-    QSqlQueryModel *tableModel;
-    QSortFilterProxyModel *qsfpm;
-
-    QSqlQueryModel *readonlyModel;
-    QSortFilterProxyModel *readonlyProxy;
-
-    QStack<QLayoutItem*> *searchWidgetStack;
+    CompactTableModel *tableModel;
+    LazyRowSizer *rowSizer;
+    ColumnWidthEstimator *widthEstimator;
+
+    // Paged model of the read-only view selector, kept until the data changes
+    struct SelectorModel {
+        LookupModel *model;
+        int dataVersion;
+    };
+    QHash<QString, SelectorModel> selectorModels;
+
+    // Transfers of the neighbouring entries of the read-only view selector, which are being fetched in the background
+    QThread *prefetchThread;
+    TransferPrefetcher *prefetcher;
+    QSet<QString> prefetchPending;
+    int prefetchVersion;
+
+    // Status of the in-memory working copy
+    QLabel *persistLabel;
+    QTimer *persistTimer;
+
+    // Detection of changes by other instances and the arguments of the displayed query to repeat it
+    QTimer *changeTimer;
+    struct ShownQuery {
+        QString table;
+        SearchFilter filter;
+    };
+    ShownQuery shownQuery;
+
+    // Rows of the search conditions and the columns to choose from (displayed name and database name)
+    QList<SearchRow*> searchRows;
+    QMap<QString, QString> searchFields;
 
     ConfigManager cm;
 
@@ -125,20 +192,39 @@ private:
 
     QStringList filefiltersSqlite;
     QStringList filefiltersCsv;
+    QStringList filefiltersChangeset;
+    QStringList filefiltersDump;
 
     QString getSelectedId() const;
     QSqlQuery getSelectedQuery();
 
-    void adjustModel(const QString &table, const QStringList &addcols = QStringList(), const QStringList &addvals = QStringList(), const QStringList &connectrelation = QStringList());
+    void adjustModel(const QString &table, const SearchFilter &filter = SearchFilter());
 
     void enablePrint();
     void enableModify();
     void enableSearchButtons();
     void visibilityReadonly();
+    LookupModel *selectorModel(const QString &view);
+    void clearSelectorModels();
+    void prefetchNeighbours(int index);
+    void initPersistStatus();
+    void refreshView();
+    static QStringList viewTables(const QString &view);
 
     void resetViewAndSearch(bool makeEmpty);
+    void updateDetailPane();
+    void addDetailItem(const QString &name, const TransferGraph::Entry &entry, int transfers);
+    SearchRow *createSearchRow(SearchRow *after = nullptr);
+    void enableSearchRemove();
 
     bool isReadonly(const QString &view);
+    bool isReport(const QString &view);
+    bool hasTimes(const QString &view);
+    SearchFilter timeCondition(const QString &view, const QString &field, SearchFilter::Operator op, qint64 time) const;
+    SearchFilter similarCondition(const QString &view, const QString &field, const QString &text, bool *truncated = nullptr);
+    static QDate semesterStart(const QDate &date);
+    static QDate nextSemester(const QDate &start);
+    static qint64 toEpoch(const QDate &date);
     bool isDeleteAllowed();
     bool isAddAllowed();
     bool isEditAllowed();
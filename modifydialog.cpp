@@ -48,7 +48,9 @@ ModifyDialog::ModifyDialog(const QString &view, QWidget *parent, bool add) :
     QDialog(parent),
     ui(new Ui::ModifyDialog),
     view(view),
-    isAdd(add)
+    isAdd(add),
+    nameIndex(nullptr),
+    excludeId(-1)
 {
     ui->setupUi(this);
     initGuiElements();
@@ -80,6 +82,8 @@ void ModifyDialog::initGuiElements()
         ui->otherLabel->setText(tr("PO"));
     }
     setWindowTitle(tr("%1 %2").arg(action).arg(type));
+    ui->similarLabel->hide();
+    ui->similarList->hide();
 }
 
 /*!
@@ -133,3 +137,79 @@ QString ModifyDialog::getOtherValue()
 {
     return ui->otherLineEdit->text();
 }
+
+/*!
+ * \brief Sets the index \a index of the existing names to suggest similar entries from
+ *
+ * While the name is typed, the most similar existing entries are listed, so that near-duplicates are noticed.
+ * The entry \a excludeId, i.e. the edited one, is not suggested.
+ *
+ * \since 3.3
+ */
+void ModifyDialog::setNameIndex(const TrigramIndex *index, int excludeId)
+{
+    nameIndex = index;
+    this->excludeId = excludeId;
+    updateSimilar();
+}
+
+/*!
+ * \brief The name was edited to \a text
+ *
+ * \since 3.3
+ */
+void ModifyDialog::on_nameLineEdit_textEdited(const QString &text)
+{
+    Q_UNUSED(text)
+    updateSimilar();
+}
+
+/*!
+ * \brief The origin or PO was edited to \a text
+ *
+ * Entries of the same origin or PO are ranked higher.
+ *
+ * \since 3.3
+ */
+void ModifyDialog::on_otherLineEdit_textEdited(const QString &text)
+{
+    Q_UNUSED(text)
+    updateSimilar();
+}
+
+/*!
+ * \brief The ECTS were changed to \a value
+ *
+ * Entries of the same ECTS are ranked higher.
+ *
+ * \since 3.3
+ */
+void ModifyDialog::on_ectsSpinBox_valueChanged(int value)
+{
+    Q_UNUSED(value)
+    updateSimilar();
+}
+
+/*!
+ * \brief Lists the existing entries which are similar to the entered one
+ *
+ * The list is hidden if there are none.
+ *
+ * \since 3.3
+ */
+void ModifyDialog::updateSimilar()
+{
+    ui->similarList->clear();
+    QList<TrigramIndex::Match> matches;
+    if(nameIndex) {
+        matches = nameIndex->similar(getNameValue(), getOtherValue(), getEctsValue(), similar_limit, excludeId);
+    }
+
+    for(int i = 0; i < matches.size(); i++) {
+        const TrigramIndex::Match &match = matches.at(i);
+        QListWidgetItem *item = new QListWidgetItem(tr("%1 (%2 ECTS, %3)").arg(match.name, QString::number(match.ects), match.other), ui->similarList);
+        item->setToolTip(tr("%1 % similar").arg(qRound(match.similarity * 100)));
+    }
+    ui->similarLabel->setVisible(!matches.isEmpty());
+    ui->similarList->setVisible(!matches.isEmpty());
+}
@@ -25,6 +25,10 @@
 #include <QDialog>
 #include <QSqlQuery>
 #include <QSqlRecord>
+#include "trigramindex.h"
+
+// Largest number of similar entries suggested
+#define similar_limit 5
 
 namespace Ui {
 class ModifyDialog;
@@ -45,10 +49,21 @@ public:
     int getEctsValue();
     QString getOtherValue();
 
+    void setNameIndex(const TrigramIndex *index, int excludeId = -1);
+
+private slots:
+    void on_nameLineEdit_textEdited(const QString &text);
+    void on_otherLineEdit_textEdited(const QString &text);
+    void on_ectsSpinBox_valueChanged(int value);
+
 private:
     Ui::ModifyDialog *ui;
     QString view;
     bool isAdd;
+    const TrigramIndex *nameIndex;
+    int excludeId;
+
+    void updateSimilar();
 };
 
 #endif // MODIFYDIALOG_H
@@ -0,0 +1,133 @@
+/*
+ * querycache.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "querycache.h"
+
+/*!
+ * \class QueryCache
+ *
+ * \brief Keeps the results of recently executed queries
+ *
+ * The results are stored under a key made of all parts of the query, see \l key().
+ * All results belong to one data version of the database, see \l Database::dataVersion().
+ * Accessing the cache with another version discards all results, as any of them might be outdated.
+ *
+ * The number of cells of all results is bounded. When it is exceeded,
+ * the least recently used results are discarded first.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs an empty QueryCache holding at most \a maxCells cells
+ */
+QueryCache::QueryCache(int maxCells) :
+    version(-1),
+    cells(0),
+    maxCells(maxCells)
+{
+}
+
+/*!
+ * \brief Returns the key of a query
+ *
+ * The arguments \a table, \a filter and \a selectcols are the same as for \l Database::executeQuery().
+ * As the filter is canonical, equivalent searches share the same key.
+ */
+QString QueryCache::key(const QString &table, const SearchFilter &filter, const QString &selectcols)
+{
+    // Separated by characters which do not occur in the parts themselves
+    QStringList parts;
+    parts << table << selectcols << filter.key();
+    return parts.join(QChar(0x1e));
+}
+
+/*!
+ * \brief Looks up the result stored under \a key for data version \a version
+ *
+ * If present, it is stored in \a table and \c true is returned.
+ * Otherwise \c false is returned.
+ */
+bool QueryCache::lookup(const QString &key, int version, CompactTable &table)
+{
+    checkVersion(version);
+    QHash<QString, Entry>::const_iterator it = entries.constFind(key);
+    if(it == entries.constEnd()) {
+        return false;
+    }
+    table = it->table;
+    recentKeys.removeOne(key);
+    recentKeys.append(key);
+    return true;
+}
+
+/*!
+ * \brief Returns whether a result is stored under \a key for data version \a version
+ */
+bool QueryCache::contains(const QString &key, int version) const
+{
+    return (version == this->version) && entries.contains(key);
+}
+
+/*!
+ * \brief Stores the result \a table of data version \a version under \a key
+ *
+ * The least recently used results are discarded as long as the cells exceed the bound.
+ * A result which is larger than the bound by itself is not stored at all.
+ */
+void QueryCache::insert(const QString &key, int version, const CompactTable &table)
+{
+    checkVersion(version);
+    Entry entry = { table, qMax(1, table.rowCount() * table.columnCount()) };
+    if(entry.cells > maxCells) return;
+
+    if(entries.contains(key)) {
+        cells -= entries.value(key).cells;
+        recentKeys.removeOne(key);
+    }
+    while(cells + entry.cells > maxCells && !recentKeys.isEmpty()) {
+        cells -= entries.take(recentKeys.takeFirst()).cells;
+    }
+    entries.insert(key, entry);
+    recentKeys.append(key);
+    cells += entry.cells;
+}
+
+/*!
+ * \brief Discards all results
+ */
+void QueryCache::clear()
+{
+    entries.clear();
+    recentKeys.clear();
+    cells = 0;
+}
+
+/*!
+ * \brief Discards all results if they belong to another data version than \a version
+ */
+void QueryCache::checkVersion(int version)
+{
+    if(version != this->version) {
+        clear();
+        this->version = version;
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * querycache.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUERYCACHE_H
+#define QUERYCACHE_H
+
+// Largest number of cells kept in the cache
+#define query_cache_cells 1000000
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include "compacttable.h"
+#include "searchfilter.h"
+
+class QueryCache
+{
+public:
+    explicit QueryCache(int maxCells = query_cache_cells);
+
+    static QString key(const QString &table, const SearchFilter &filter, const QString &selectcols);
+
+    bool lookup(const QString &key, int version, CompactTable &table);
+    bool contains(const QString &key, int version) const;
+    void insert(const QString &key, int version, const CompactTable &table);
+    void clear();
+
+private:
+    struct Entry {
+        CompactTable table;
+        int cells;
+    };
+
+    QHash<QString, Entry> entries;
+    QList<QString> recentKeys;
+    int version;
+    int cells;
+    int maxCells;
+
+    void checkVersion(int version);
+};
+
+#endif // QUERYCACHE_H
@@ -0,0 +1,237 @@
+/*
+ * searchfilter.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "searchfilter.h"
+#include <algorithm>
+
+/*!
+ * \class SearchFilter
+ *
+ * \brief Typed restriction of the entries of a query
+ *
+ * A filter is either empty, a single condition on a column or a group of filters,
+ * which are all or any of them to be fulfilled. Groups can be nested arbitrarily.
+ *
+ * Each filter is compiled into a SQL clause with placeholders when it is constructed, see \l sql() and \l values().
+ * The clause is canonical: nested groups of the same kind are merged, duplicates are dropped and
+ * the filters of a group are sorted. So equivalent searches result in identical statements,
+ * which share their entry in the query cache of the database.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs an empty filter, which matches all entries
+ */
+SearchFilter::SearchFilter() : kind(EmptyFilter), connective(All)
+{}
+
+/*!
+ * \brief Returns the condition \a op with the value \a value on the column \a field
+ *
+ * \a field is inserted into the statement as it is, so it may also be an expression.
+ * For \c Contains and \c NotContains the value is searched as text, special characters of \c LIKE are escaped.
+ * \c Similar needs the names of the entries and is to be resolved by the caller into \l oneOf(),
+ * here it is compiled like \c Contains.
+ * A null \a value is compared as \c NULL.
+ *
+ * If \a table is given, the column \a field belongs to that table instead of the queried one.
+ * The condition then matches the entries whose ID is found in \a table, which allows to use an index of \a table.
+ */
+SearchFilter SearchFilter::condition(const QString &field, Operator op, const QVariant &value, const QString &table)
+{
+    SearchFilter filter;
+    filter.kind = ConditionFilter;
+
+    QString relation;
+    QVariant param = value;
+    switch(op) {
+    case Contains:
+    case Similar:
+        relation = " LIKE ? ESCAPE '!'";
+        param = "%" + escapeLike(value.toString()) + "%";
+        break;
+    case NotContains:
+        relation = " NOT LIKE ? ESCAPE '!'";
+        param = "%" + escapeLike(value.toString()) + "%";
+        break;
+    case Equals:
+        relation = " IS ?";
+        break;
+    case NotEquals:
+        relation = " IS NOT ?";
+        break;
+    case AtLeast:
+        relation = " >= ?";
+        break;
+    case Below:
+        relation = " < ?";
+        break;
+    }
+
+    if(table.isEmpty()) {
+        filter.clause = field + relation;
+    } else {
+        filter.clause = QString("ID IN (SELECT ID FROM %1 WHERE %2%3)").arg(table).arg(field).arg(relation);
+    }
+    filter.params << param;
+    return filter;
+}
+
+/*!
+ * \brief Returns the condition that the column \a field is one of \a ids
+ *
+ * The IDs are sorted, so that the order in which they were found does not matter.
+ * An empty list of IDs matches no entry.
+ */
+SearchFilter SearchFilter::oneOf(const QString &field, const QList<int> &ids)
+{
+    QList<int> sorted = ids;
+    std::sort(sorted.begin(), sorted.end());
+
+    SearchFilter filter;
+    filter.kind = ConditionFilter;
+    QStringList placeholders;
+    for(int i = 0; i < sorted.size(); i++) {
+        if(i > 0 && sorted.at(i) == sorted.at(i - 1)) continue;
+        placeholders << "?";
+        filter.params << sorted.at(i);
+    }
+    filter.clause = QString("%1 IN (%2)").arg(field).arg(placeholders.join(", "));
+    return filter;
+}
+
+/*!
+ * \brief Returns the group of \a filters, which are connected by \a connective
+ *
+ * Filters which are groups of the same connective are merged into the new group.
+ * As an empty filter matches all entries, it is left out of an \c All group,
+ * whereas an \c Any group containing it matches all entries as well and is thus empty.
+ * A group of a single filter is that filter itself and a group without any filter is empty.
+ */
+SearchFilter SearchFilter::group(Connective connective, const QList<SearchFilter> &filters)
+{
+    // merge nested groups of the same connective and leave out empty filters
+    // (the map sorts the filters by their keys, so neither their order nor duplicates matter)
+    QMap<QString, SearchFilter> members;
+    for(int i = 0; i < filters.size(); i++) {
+        const SearchFilter &filter = filters.at(i);
+        if(filter.kind == EmptyFilter && connective == Any) {
+            return SearchFilter();
+        }
+        if(filter.kind == GroupFilter && filter.connective == connective) {
+            for(int j = 0; j < filter.children.size(); j++) {
+                members.insert(filter.children.at(j).key(), filter.children.at(j));
+            }
+        } else if(filter.kind != EmptyFilter) {
+            members.insert(filter.key(), filter);
+        }
+    }
+    if(members.size() < 2) {
+        return members.isEmpty() ? SearchFilter() : members.first();
+    }
+
+    SearchFilter filter;
+    filter.kind = GroupFilter;
+    filter.connective = connective;
+    QStringList clauses;
+    QMap<QString, SearchFilter>::const_iterator it = members.constBegin();
+    while(it != members.constEnd()) {
+        filter.children << it.value();
+        // the other connective always needs parentheses
+        clauses << (it->kind == GroupFilter ? "(" + it->clause + ")" : it->clause);
+        filter.params << it->params;
+        ++it;
+    }
+    filter.clause = clauses.join(connective == All ? " AND " : " OR ");
+    return filter;
+}
+
+/*!
+ * \brief Returns the group of \a filters, which all need to be fulfilled
+ */
+SearchFilter SearchFilter::all(const QList<SearchFilter> &filters)
+{
+    return group(All, filters);
+}
+
+/*!
+ * \brief Returns the group of \a filters, of which any needs to be fulfilled
+ */
+SearchFilter SearchFilter::any(const QList<SearchFilter> &filters)
+{
+    return group(Any, filters);
+}
+
+/*!
+ * \brief Returns \c true if the filter matches all entries
+ */
+bool SearchFilter::isEmpty() const
+{
+    return kind == EmptyFilter;
+}
+
+/*!
+ * \brief Returns the clause of the filter to be used after \c WHERE
+ *
+ * The values are given by placeholders, see \l values(). The clause is empty for an empty filter.
+ */
+QString SearchFilter::sql() const
+{
+    return clause;
+}
+
+/*!
+ * \brief Returns the values to be bound to the placeholders of \l sql() in their order
+ */
+QVariantList SearchFilter::values() const
+{
+    return params;
+}
+
+/*!
+ * \brief Returns a text identifying the filter together with its values
+ *
+ * Two filters have the same key if and only if they result in the same statement and values.
+ */
+QString SearchFilter::key() const
+{
+    // Separated by characters which do not occur in the parts themselves
+    QStringList parts;
+    parts << clause;
+    for(int i = 0; i < params.size(); i++) {
+        const QVariant &param = params.at(i);
+        parts << (param.isNull() ? QString("null") : QString(param.typeName()) + ":" + param.toString());
+    }
+    return parts.join(QChar(0x1f));
+}
+
+/*!
+ * \brief Returns \a text with the special characters of \c LIKE escaped by \c !
+ */
+QString SearchFilter::escapeLike(const QString &text)
+{
+    QString escaped = text;
+    return escaped.replace("!", "!!")
+            .replace("%", "!%")
+            .replace("_", "!_")
+            .replace("[", "![");
+}
@@ -0,0 +1,81 @@
+/*
+ * searchfilter.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCHFILTER_H
+#define SEARCHFILTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <QVariant>
+#include <QVariantList>
+
+class SearchFilter
+{
+public:
+    // Relation between a column and the value of a condition
+    enum Operator {
+        Contains,
+        NotContains,
+        Equals,
+        NotEquals,
+        AtLeast,
+        Below,
+        Similar
+    };
+
+    // How the filters of a group are connected
+    enum Connective {
+        All,
+        Any
+    };
+
+    SearchFilter();
+
+    static SearchFilter condition(const QString &field, Operator op, const QVariant &value, const QString &table = QString());
+    static SearchFilter oneOf(const QString &field, const QList<int> &ids);
+    static SearchFilter group(Connective connective, const QList<SearchFilter> &filters);
+    static SearchFilter all(const QList<SearchFilter> &filters);
+    static SearchFilter any(const QList<SearchFilter> &filters);
+    static QString escapeLike(const QString &text);
+
+    bool isEmpty() const;
+    QString sql() const;
+    QVariantList values() const;
+    QString key() const;
+
+private:
+    enum Kind {
+        EmptyFilter,
+        ConditionFilter,
+        GroupFilter
+    };
+
+    Kind kind;
+    Connective connective;
+    QList<SearchFilter> children;
+    // The compiled clause with its placeholders and the values bound to them in that order
+    QString clause;
+    QVariantList params;
+};
+
+#endif // SEARCHFILTER_H
@@ -0,0 +1,176 @@
+/*
+ * searchrow.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "searchrow.h"
+
+/*!
+ * \class SearchRow
+ *
+ * \brief Row of input elements for a single search condition
+ *
+ * The row consists of a combobox for the column, one for the relation, the input of the value
+ * and the buttons to add another row or to remove this one.
+ * The rows are created on demand by the main window, so the number of conditions is not limited.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the SearchRow
+ *
+ * \a parent is passed to the QWidget constructor.
+ */
+SearchRow::SearchRow(QWidget *parent) : QWidget(parent)
+{
+    QHBoxLayout *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    fieldBox = new QComboBox(this);
+    fieldBox->setLocale(QLocale(QLocale::German, QLocale::Germany));
+    fieldBox->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    layout->addWidget(fieldBox);
+
+    relationBox = new QComboBox(this);
+    relationBox->addItem(tr("contains"), SearchFilter::Contains);
+    relationBox->addItem(tr("does not contain"), SearchFilter::NotContains);
+    relationBox->addItem(tr("equals"), SearchFilter::Equals);
+    relationBox->addItem(tr("does not equal"), SearchFilter::NotEquals);
+    relationBox->addItem(tr("similar to"), SearchFilter::Similar);
+    layout->addWidget(relationBox);
+
+    inputEdit = new QLineEdit(this);
+    inputEdit->setLocale(QLocale(QLocale::German, QLocale::Germany));
+    inputEdit->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    inputEdit->setClearButtonEnabled(true);
+    layout->addWidget(inputEdit);
+
+    addButton = new QPushButton("+", this);
+    layout->addWidget(addButton);
+    connect(addButton, SIGNAL(clicked()), this, SLOT(addClicked()));
+
+    removeButton = new QPushButton("-", this);
+    layout->addWidget(removeButton);
+    connect(removeButton, SIGNAL(clicked()), this, SLOT(removeClicked()));
+}
+
+/*!
+ * \brief Sets the columns to choose from to \a fields
+ *
+ * The keys of \a fields are displayed, the values are the names of the columns (or expressions) in the database.
+ * The columns are sorted by their displayed names.
+ */
+void SearchRow::setFields(const QMap<QString, QString> &fields)
+{
+    fieldBox->clear();
+    QMap<QString, QString>::const_iterator it = fields.constBegin();
+    while(it != fields.constEnd()) {
+        fieldBox->addItem(it.key(), it.value());
+        ++it;
+    }
+    fieldBox->model()->sort(0);
+}
+
+/*!
+ * \brief Returns the index of the first column whose database name contains \a text or -1 if there is none
+ */
+int SearchRow::findField(const QString &text) const
+{
+    return fieldBox->findData(text, Qt::UserRole, Qt::MatchContains);
+}
+
+/*!
+ * \brief Selects the column of index \a fieldIndex and clears the relation and the input
+ */
+void SearchRow::reset(int fieldIndex)
+{
+    fieldBox->setCurrentIndex(fieldIndex);
+    relationBox->setCurrentIndex(0);
+    inputEdit->clear();
+}
+
+/*!
+ * \brief Enables the remove button if \a removable is \c true, otherwise disables it
+ */
+void SearchRow::setRemovable(bool removable)
+{
+    removeButton->setEnabled(removable);
+}
+
+/*!
+ * \brief Returns the database name of the selected column, which is empty if no column is selected
+ */
+QString SearchRow::field() const
+{
+    return fieldBox->currentData().toString();
+}
+
+/*!
+ * \brief Returns the selected relation
+ */
+SearchFilter::Operator SearchRow::relation() const
+{
+    return static_cast<SearchFilter::Operator>(relationBox->currentData().toInt());
+}
+
+/*!
+ * \brief Returns the input value
+ */
+QString SearchRow::text() const
+{
+    return inputEdit->text();
+}
+
+/*!
+ * \brief Returns the search condition of the row
+ *
+ * An empty input is compared as \c NULL by the relations \e equals and \e {does not equal}.
+ * The relation \e {similar to} is left to the caller, see SearchFilter::condition().
+ * The filter is empty if no column is selected.
+ */
+SearchFilter SearchRow::filter() const
+{
+    if(field().isEmpty()) {
+        return SearchFilter();
+    }
+
+    SearchFilter::Operator op = relation();
+    QVariant value = text();
+    if(text().isEmpty() && (op == SearchFilter::Equals || op == SearchFilter::NotEquals)) {
+        value = QVariant(QVariant::String);
+    }
+    return SearchFilter::condition(field(), op, value);
+}
+
+/*!
+ * \brief The add button is clicked
+ */
+void SearchRow::addClicked()
+{
+    emit addRequested(this);
+}
+
+/*!
+ * \brief The remove button is clicked
+ */
+void SearchRow::removeClicked()
+{
+    emit removeRequested(this);
+}
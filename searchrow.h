@@ -0,0 +1,66 @@
+/*
+ * searchrow.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCHROW_H
+#define SEARCHROW_H
+
+#include <QWidget>
+#include <QHBoxLayout>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QMap>
+#include "searchfilter.h"
+
+class SearchRow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SearchRow(QWidget *parent = nullptr);
+
+    void setFields(const QMap<QString, QString> &fields);
+    int findField(const QString &text) const;
+    void reset(int fieldIndex);
+    void setRemovable(bool removable);
+
+    QString field() const;
+    SearchFilter::Operator relation() const;
+    QString text() const;
+    SearchFilter filter() const;
+
+signals:
+    void addRequested(SearchRow *row);
+    void removeRequested(SearchRow *row);
+
+private slots:
+    void addClicked();
+    void removeClicked();
+
+private:
+    QComboBox *fieldBox;
+    QComboBox *relationBox;
+    QLineEdit *inputEdit;
+    QPushButton *addButton;
+    QPushButton *removeButton;
+};
+
+#endif // SEARCHROW_H
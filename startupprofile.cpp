@@ -0,0 +1,104 @@
+/*
+ * startupprofile.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "startupprofile.h"
+
+/*!
+ * \class StartupProfile
+ *
+ * \brief Records the duration of the phases of the application start
+ *
+ * Between \l start() and \l finish() each call of \l mark() writes the time spent
+ * since the previous mark to the debug log. Afterwards marks are ignored,
+ * so that functions also used later on (e.g. opening the database on import) do not log.
+ *
+ * \since 3.3
+ */
+
+QElapsedTimer StartupProfile::timer;
+qint64 StartupProfile::lastMark = 0;
+bool StartupProfile::active = false;
+
+/*!
+ * \brief Starts the profile
+ */
+void StartupProfile::start()
+{
+    timer.start();
+    lastMark = 0;
+    active = true;
+}
+
+/*!
+ * \brief Logs the time spent in the phase of name \a phase
+ *
+ * The phase is considered to have started at the previous mark or at the start of the profile.
+ */
+void StartupProfile::mark(const QString &phase)
+{
+    if(!active) return;
+
+    qint64 now = timer.elapsed();
+    qDebug() << QObject::tr("Startup phase '%1' took %2 ms (%3 ms in total)").arg(phase).arg(now - lastMark).arg(now);
+    lastMark = now;
+}
+
+/*!
+ * \brief Finishes the profile
+ *
+ * The total time of the application start is logged.
+ */
+void StartupProfile::finish()
+{
+    if(!active) return;
+
+    qDebug() << QObject::tr("Startup finished after %1 ms").arg(timer.elapsed());
+    active = false;
+}
+
+/*!
+ * \brief Finishes the profile when \a window is painted for the first time
+ *
+ * The phase up to the first paint is logged as \e {first paint}, so the total is the time until the window is seen.
+ * Showing a window only schedules its painting, which happens when the event loop runs.
+ */
+void StartupProfile::finishOnPaint(QWidget *window)
+{
+    if(!active) return;
+
+    window->installEventFilter(new PaintWatcher(window));
+}
+
+/*!
+ * \brief Watches for the first paint event of \a watched
+ *
+ * Then the profile is finished and the watcher removes itself. Returns \c false as \a event is never consumed.
+ */
+bool StartupProfile::PaintWatcher::eventFilter(QObject *watched, QEvent *event)
+{
+    if(event->type() == QEvent::Paint) {
+        mark("first paint");
+        finish();
+        watched->removeEventFilter(this);
+        deleteLater();
+    }
+    return QObject::eventFilter(watched, event);
+}
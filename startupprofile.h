@@ -0,0 +1,54 @@
+/*
+ * startupprofile.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QEvent>
+#include <QWidget>
+#include <QtDebug>
+
+class StartupProfile
+{
+public:
+    static void start();
+    static void mark(const QString &phase);
+    static void finish();
+    static void finishOnPaint(QWidget *window);
+
+private:
+    // Finishes the profile when the watched window is painted for the first time
+    class PaintWatcher : public QObject
+    {
+    public:
+        explicit PaintWatcher(QObject *parent) : QObject(parent) {}
+    protected:
+        bool eventFilter(QObject *watched, QEvent *event) Q_DECL_OVERRIDE;
+    };
+
+    static QElapsedTimer timer;
+    static qint64 lastMark;
+    static bool active;
+};
+
+#endif // STARTUPPROFILE_H
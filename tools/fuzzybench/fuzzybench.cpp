@@ -0,0 +1,105 @@
+/*
+ * fuzzybench.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Benchmark of the typo-tolerant name search of FuzzyMatcher
+ *
+ * A number of names is generated from the words of course and module names with a fixed seed
+ * and loaded into a FuzzyMatcher. Then each of a few misspelled texts is searched several times
+ * with the limit of the "similar to" search of the main window. For each text the number of matches
+ * and the fastest and median time of a search are reported.
+ *
+ * Usage: fuzzybench [names] [repetitions]
+ *
+ * The defaults are 1000000 names and 20 repetitions.
+ */
+
+#include "fuzzymatcher.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <random>
+
+// The limit of the "similar to" search, see mainwindow.h
+#define bench_limit 500
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    int count = args.size() > 1 ? args.at(1).toInt() : 1000000;
+    int repetitions = args.size() > 2 ? args.at(2).toInt() : 20;
+    QTextStream out(stdout);
+
+    QStringList words;
+    words << "Analysis" << "Lineare" << "Algebra" << "Stochastik" << "Einführung" << "in" << "die" << "der"
+          << "Informatik" << "Programmierung" << "Datenbanksysteme" << "Theoretische" << "Physik" << "Statistik"
+          << "Numerik" << "Grundlagen" << "Wirtschaftsmathematik" << "Seminar" << "Praktikum" << "für"
+          << "Fortgeschrittene" << "Informatiker" << "Ökonometrie" << "Optimierung" << "Methoden"
+          << "Angewandte" << "Diskrete" << "Strukturen" << "Rechnernetze" << "Betriebssysteme"
+          << "Softwaretechnik" << "Maschinelles" << "Lernen" << "Graphentheorie" << "Funktionalanalysis"
+          << "I" << "II" << "III" << "A" << "B";
+
+    std::mt19937 random(20261018);
+    std::uniform_int_distribution<int> wordCount(2, 5);
+    std::uniform_int_distribution<int> word(0, words.size() - 1);
+    std::uniform_int_distribution<int> number(1, 9999);
+
+    FuzzyMatcher matcher;
+    QElapsedTimer timer;
+    timer.start();
+    for(int i = 0; i < count; i++) {
+        QStringList parts;
+        int n = wordCount(random);
+        for(int w = 0; w < n; w++) {
+            parts << words.at(word(random));
+        }
+        parts << QString::number(number(random));
+        matcher.insert(i + 1, parts.join(' '));
+    }
+    out << count << " names loaded in " << timer.elapsed() << " ms, "
+        << QThreadPool::globalInstance()->maxThreadCount() << " threads" << endl;
+
+    QStringList texts;
+    texts << "Stochastk" << "Lineare Algbra" << "Datenbanksysteem" << "Funktionalanalysys" << "Graphentheorie II"
+          << "Quantenmechanik" << "Ana";
+    out << QString("%1 %2 %3 %4").arg("text", -20).arg("matches", 8).arg("min ms", 8).arg("median ms", 10) << endl;
+    for(int t = 0; t < texts.size(); t++) {
+        QVector<qint64> times;
+        int matches = 0;
+        for(int r = 0; r < repetitions; r++) {
+            timer.start();
+            matches = matcher.search(texts.at(t), bench_limit + 1).size();
+            times << timer.nsecsElapsed();
+        }
+        std::sort(times.begin(), times.end());
+        QString shown = matches > bench_limit ? QString("> %1").arg(bench_limit) : QString::number(matches);
+        out << QString("%1 %2 %3 %4").arg(texts.at(t), -20).arg(shown, 8)
+               .arg(times.first() / 1e6, 8, 'f', 1).arg(times.at(times.size() / 2) / 1e6, 10, 'f', 1) << endl;
+    }
+    return 0;
+}
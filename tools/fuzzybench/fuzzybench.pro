@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# Benchmark of the typo-tolerant name search,
+# built separately from the application: qmake && make
+#
+#-------------------------------------------------
+
+QT       += core sql concurrent
+QT       -= gui
+
+TARGET = fuzzybench
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += fuzzybench.cpp \
+    ../../fuzzymatcher.cpp
+
+HEADERS += ../../fuzzymatcher.h
@@ -0,0 +1,301 @@
+/*
+ * lockstress.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Stress test of the locking of a database file shared by several instances
+ *
+ * A number of writer processes insert entries into one database file at the same time.
+ * Each one waits for the locks of the others with the same busy handler as Database::busyHandler()
+ * (increasing intervals from 1 ms up to 100 ms, giving up after 10 s) and collects the same statistics.
+ * At the end the waits of each writer and of all writers together are reported.
+ *
+ * Optionally a reader process browses the entries by name while the writers run, like the read-only view selector:
+ *   held   steps a SELECT over all entries once and keeps it open for hold ms, as a partly fetched QSqlQueryModel does.
+ *          Its SHARED lock keeps every COMMIT waiting, so the writers fail once the hold exceeds 10 s.
+ *   paged  reads the entries in pages of 200 like the LookupModel, each page completely with its statement finished,
+ *          until the writers are done. The writers only wait for the short reads.
+ *
+ * Usage: lockstress [file] [writers] [transactions] [rows] [none|held|paged] [hold ms]
+ *
+ * The defaults are lockstress.sqlite, 8 writers, 200 transactions per writer, 10 rows per transaction,
+ * no reader and a hold of 15000 ms. For a reader the file is filled with at least 1000 entries beforehand.
+ * The file is created if it does not exist. As the writers are forked, this runs on POSIX systems only.
+ */
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define busy_max_wait 10000
+#define page_size 200
+#define reader_entries 1000
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Statistics {
+    int transactions = 0;
+    int failures = 0;
+    std::vector<double> waits;
+};
+
+struct LockWait {
+    bool waiting = false;
+    Clock::time_point start;
+};
+
+LockWait lockWait;
+Statistics statistics;
+
+double elapsed(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// The time waited for the last lock, once the statement it blocked has returned
+void finishLockWait()
+{
+    if(!lockWait.waiting) return;
+    lockWait.waiting = false;
+    statistics.waits.push_back(elapsed(lockWait.start));
+}
+
+// The same as Database::busyHandler()
+int busyHandler(void *data, int count)
+{
+    (void) data;
+    static const int delays[] = { 1, 2, 5, 10, 20, 50, 100 };
+    static const int delayCount = sizeof(delays) / sizeof(delays[0]);
+
+    if(count == 0) {
+        finishLockWait();
+        lockWait.waiting = true;
+        lockWait.start = Clock::now();
+    }
+    if(elapsed(lockWait.start) >= busy_max_wait) {
+        finishLockWait();
+        return 0;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(delays[std::min(count, delayCount - 1)]));
+    return 1;
+}
+
+bool execute(sqlite3 *db, const char *sql)
+{
+    int rc = sqlite3_exec(db, sql, nullptr, nullptr, nullptr);
+    finishLockWait();
+    return rc == SQLITE_OK;
+}
+
+// Inserts the entries of one writer, the statistics are written to the pipe fd
+int writer(const std::string &file, int number, int transactions, int rows, int fd)
+{
+    sqlite3 *db = nullptr;
+    if(sqlite3_open_v2(file.c_str(), &db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+        std::fprintf(stderr, "writer %d: %s\n", number, sqlite3_errmsg(db));
+        return 1;
+    }
+    sqlite3_busy_handler(db, &busyHandler, nullptr);
+
+    sqlite3_stmt *insert = nullptr;
+    sqlite3_prepare_v2(db, "INSERT INTO Kurse (Kursname, ECTS, Zeit) VALUES (?, ?, CAST(strftime('%s', 'now') AS INTEGER))", -1, &insert, nullptr);
+    for(int t = 0; t < transactions; t++) {
+        bool success = execute(db, "BEGIN");
+        for(int r = 0; success && r < rows; r++) {
+            std::string name = "Kurs " + std::to_string(number) + "-" + std::to_string(t) + "-" + std::to_string(r);
+            sqlite3_bind_text(insert, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_double(insert, 2, 5.0);
+            success = (sqlite3_step(insert) == SQLITE_DONE);
+            finishLockWait();
+            sqlite3_reset(insert);
+        }
+        success = success && execute(db, "COMMIT");
+        if(success) {
+            statistics.transactions++;
+        } else {
+            statistics.failures++;
+            execute(db, "ROLLBACK");
+        }
+    }
+    sqlite3_finalize(insert);
+    sqlite3_close(db);
+
+    std::string result = std::to_string(statistics.transactions) + " " + std::to_string(statistics.failures);
+    for(size_t i = 0; i < statistics.waits.size(); i++) {
+        result += " " + std::to_string(statistics.waits[i]);
+    }
+    result += "\n";
+    ssize_t written = write(fd, result.c_str(), result.size());
+    return written == static_cast<ssize_t>(result.size()) ? 0 : 1;
+}
+
+// Browses the entries by name in the given mode until it is terminated
+int reader(const std::string &file, const std::string &mode, int hold)
+{
+    sqlite3 *db = nullptr;
+    if(sqlite3_open_v2(file.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        std::fprintf(stderr, "reader: %s\n", sqlite3_errmsg(db));
+        return 1;
+    }
+    sqlite3_busy_timeout(db, busy_max_wait);
+
+    sqlite3_stmt *select = nullptr;
+    if(mode == "held") {
+        sqlite3_prepare_v2(db, "SELECT ID, Kursname FROM Kurse ORDER BY Kursname COLLATE NOCASE", -1, &select, nullptr);
+        sqlite3_step(select);
+        std::this_thread::sleep_for(std::chrono::milliseconds(hold));
+        sqlite3_finalize(select);
+        pause();
+    } else {
+        sqlite3_prepare_v2(db, "SELECT ID, Kursname FROM Kurse ORDER BY Kursname COLLATE NOCASE LIMIT ? OFFSET ?", -1, &select, nullptr);
+        for(int offset = 0; ; ) {
+            sqlite3_bind_int(select, 1, page_size);
+            sqlite3_bind_int(select, 2, offset);
+            int count = 0;
+            while(sqlite3_step(select) == SQLITE_ROW) count++;
+            sqlite3_reset(select);
+            offset = (count < page_size) ? 0 : offset + count;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    return 0;
+}
+
+void report(const char *name, const Statistics &s)
+{
+    std::vector<double> waits = s.waits;
+    std::sort(waits.begin(), waits.end());
+    double total = 0;
+    for(size_t i = 0; i < waits.size(); i++) total += waits[i];
+    double mean = waits.empty() ? 0 : total / waits.size();
+    double p95 = waits.empty() ? 0 : waits[std::min(waits.size() - 1, waits.size() * 95 / 100)];
+    double longest = waits.empty() ? 0 : waits.back();
+    std::printf("%-8s %6d %6d %7zu %10.0f %8.1f %8.1f %8.1f\n",
+                name, s.transactions, s.failures, waits.size(), total, mean, p95, longest);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    std::string file = argc > 1 ? argv[1] : "lockstress.sqlite";
+    int writers = argc > 2 ? std::atoi(argv[2]) : 8;
+    int transactions = argc > 3 ? std::atoi(argv[3]) : 200;
+    int rows = argc > 4 ? std::atoi(argv[4]) : 10;
+    std::string mode = argc > 5 ? argv[5] : "none";
+    int hold = argc > 6 ? std::atoi(argv[6]) : 15000;
+    if(mode != "none" && mode != "held" && mode != "paged") {
+        std::fprintf(stderr, "unknown reader '%s', expected none, held or paged\n", mode.c_str());
+        return 1;
+    }
+
+    sqlite3 *db = nullptr;
+    if(sqlite3_open(file.c_str(), &db) != SQLITE_OK
+            || sqlite3_exec(db, "CREATE TABLE IF NOT EXISTS Kurse (ID INTEGER NOT NULL PRIMARY KEY, "
+                                "Kursname TEXT NOT NULL, ECTS REAL NOT NULL, Zeit INTEGER);"
+                                "CREATE INDEX IF NOT EXISTS KurseKursname ON Kurse(Kursname COLLATE NOCASE)", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::fprintf(stderr, "%s: %s\n", file.c_str(), sqlite3_errmsg(db));
+        return 1;
+    }
+    if(mode != "none") {
+        std::string fill = "WITH RECURSIVE n(i) AS (SELECT (SELECT COUNT(*) FROM Kurse) UNION ALL SELECT i + 1 FROM n WHERE i + 1 < "
+                + std::to_string(reader_entries) + ") INSERT INTO Kurse (Kursname, ECTS) SELECT 'Kurs ' || i, 5.0 FROM n "
+                "WHERE i < " + std::to_string(reader_entries);
+        sqlite3_exec(db, fill.c_str(), nullptr, nullptr, nullptr);
+    }
+    sqlite3_close(db);
+
+    pid_t readerPid = 0;
+    if(mode != "none") {
+        readerPid = fork();
+        if(readerPid == 0) {
+            _exit(reader(file, mode, hold));
+        }
+        // let the reader take its lock before the writers start
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    std::vector<pid_t> pids;
+    std::vector<int> pipes;
+    Clock::time_point start = Clock::now();
+    for(int i = 0; i < writers; i++) {
+        int fds[2];
+        if(pipe(fds) != 0) return 1;
+        pid_t pid = fork();
+        if(pid == 0) {
+            close(fds[0]);
+            _exit(writer(file, i, transactions, rows, fds[1]));
+        }
+        close(fds[1]);
+        pids.push_back(pid);
+        pipes.push_back(fds[0]);
+    }
+
+    std::printf("%-8s %6s %6s %7s %10s %8s %8s %8s\n", "writer", "commit", "failed", "waits", "total ms", "mean ms", "p95 ms", "max ms");
+    Statistics all;
+    for(int i = 0; i < writers; i++) {
+        std::string result;
+        char buffer[4096];
+        ssize_t n;
+        while((n = read(pipes[i], buffer, sizeof(buffer))) > 0) {
+            result.append(buffer, static_cast<size_t>(n));
+        }
+        close(pipes[i]);
+        waitpid(pids[i], nullptr, 0);
+
+        Statistics s;
+        const char *p = result.c_str();
+        char *end = nullptr;
+        s.transactions = static_cast<int>(std::strtol(p, &end, 10));
+        s.failures = static_cast<int>(std::strtol(end, &end, 10));
+        for(;;) {
+            char *next = nullptr;
+            double wait = std::strtod(end, &next);
+            if(next == end) break;
+            s.waits.push_back(wait);
+            end = next;
+        }
+        report(std::to_string(i).c_str(), s);
+        all.transactions += s.transactions;
+        all.failures += s.failures;
+        all.waits.insert(all.waits.end(), s.waits.begin(), s.waits.end());
+    }
+    report("all", all);
+    if(readerPid > 0) {
+        kill(readerPid, SIGTERM);
+        waitpid(readerPid, nullptr, 0);
+    }
+    double seconds = elapsed(start) / 1000;
+    std::printf("%d writers, %s reader, %.1f s, %.0f transactions/s\n", writers, mode.c_str(), seconds, all.transactions / seconds);
+    return all.failures > 0 ? 2 : 0;
+}
@@ -0,0 +1,15 @@
+#-------------------------------------------------
+#
+# Stress test of the locking of a shared database file,
+# built separately from the application: qmake && make
+#
+#-------------------------------------------------
+
+TARGET = lockstress
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= qt app_bundle
+
+SOURCES += lockstress.cpp
+
+LIBS += -lsqlite3
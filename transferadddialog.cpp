@@ -29,6 +29,10 @@
  *
  * The dialog does some consistency checking prior to saving into the database.
  *
+ * Several courses and modules can be collected in lists, in which case a transfer
+ * is added for each pair of a listed course and a listed module.
+ * Single pairs of a course and a module can be pasted in addition, e.g. the transfers of one student.
+ *
  * \since 1.0
  */
 
@@ -38,7 +42,7 @@
  * \brief Constructs the TransferAddDialog
  *
  * The dialog takes \a mydb as Database pointer and \a parent as pointer to the parental QWidget.
- * It also sets up all the models for the course and module comboboxes by fetching the data from the database
+ * It also sets up the lookups of courses and modules by their names.
  */
 TransferAddDialog::TransferAddDialog(Database *mydb, QWidget *parent) :
     QDialog(parent),
@@ -46,9 +50,7 @@ TransferAddDialog::TransferAddDialog(Database *mydb, QWidget *parent) :
     db(mydb)
 {
     ui->setupUi(this);
-    coursemodel = new QSqlQueryModel(ui->kursNameComboBox);
-    modulemodel = new QSqlQueryModel(ui->modulNameComboBox);
-    initModels();
+    initLookups();
 }
 
 /*!
@@ -60,152 +62,452 @@ TransferAddDialog::~TransferAddDialog()
 }
 
 /*!
- * \brief Helper function to display QSqlErrors
- * \internal
+ * \brief Initialises the lookups of courses and modules
+ *
+ * Instead of loading the whole tables \tt Kurse and \tt Module, only the entries
+ * whose name starts with the text entered in the respective line edit are fetched (see \l EntryLookup).
  *
- * Prints out \a text as mesage start, followed by the error text of \a error.
- * Nothing is done when the error is not valid.
+ * Finally, the save button is disabled
  */
-void TransferAddDialog::checkError(QSqlError error, const QString &text)
+void TransferAddDialog::initLookups()
 {
-    if(error.isValid()) qCritical() << QString("%1: %2").arg(text).arg(error.text());
+    courseLookup = new EntryLookup(db, Database::displayTable("Kurse"), "Kursname", "ID, Kursname, Herkunft, ECTS", ui->kursNameLineEdit, this);
+    connect(courseLookup, SIGNAL(entrySelected(QSqlRecord)), this, SLOT(courseSelected(QSqlRecord)));
+    connect(courseLookup, SIGNAL(entryCleared()), this, SLOT(courseCleared()));
+
+    moduleLookup = new EntryLookup(db, Database::displayTable("Module"), "Modulname", "ID, Modulname, PO, ECTS", ui->modulNameLineEdit, this);
+    connect(moduleLookup, SIGNAL(entrySelected(QSqlRecord)), this, SLOT(moduleSelected(QSqlRecord)));
+    connect(moduleLookup, SIGNAL(entryCleared()), this, SLOT(moduleCleared()));
+
+    enableOkButton();
 }
 
 /*!
- * \brief Initialises the combobox models
+ * \brief Updates the GUI components for the course display
  *
- * This function fetches the contents of the tables \tt Kurse and \tt Module into separate models.
- * Each of them serves then as the source for a proxy model, which is actually used in the combobox.
+ * This function sets the ECTS and origin of the course \a record into its according GUI elements.
+ * It also saves the underlying ID in a private dialog variable.
  *
- * Those two layers are needed as sorting according to the used locale is required
- * which cannot be consistenly done on the database level.
+ * Finally, the status of the buttons and the status message to display is adjusted.
+ */
+void TransferAddDialog::courseSelected(const QSqlRecord &record)
+{
+    cid = record.value("ID").toString();
+    ui->kursEctsLineEdit->setText(record.value("ECTS").toString());
+    ui->kursHerkunftLineEdit->setText(record.value("Herkunft").toString());
+    ui->kursNameLineEdit->setToolTip(record.value("Kursname").toString());
+    ui->kursAddButton->setEnabled(true);
+
+    enableOkButton();
+}
+
+/*!
+ * \brief Resets the course display
  *
- * Finally, the save button is disabled
+ * This function is called as soon as the course name is edited, as the previous course is no longer selected.
  */
-void TransferAddDialog::initModels()
-{
-    // Setting up the course combobox
-    QSqlQuery selectcoursequery = db->executeQuery("Kurse");
-    checkError(selectcoursequery.lastError(), tr("Error in 'selectcoursequery'"));
-    coursemodel->clear();
-    coursemodel->setQuery(selectcoursequery);
-    while (coursemodel->canFetchMore()) coursemodel->fetchMore();
-    checkError(coursemodel->lastError(), tr("Error setting query to 'coursemodel'"));
-
-    QSortFilterProxyModel *coursesfpm = new QSortFilterProxyModel(this);
-    coursesfpm->setSourceModel(coursemodel);
-    coursesfpm->setSortLocaleAware(true);  
-    coursesfpm->sort(1, Qt::AscendingOrder);
-
-    ui->kursNameComboBox->blockSignals(true);
-    ui->kursNameComboBox->setModel(coursesfpm);
-    ui->kursNameComboBox->setModelColumn(1);
-    ui->kursNameComboBox->setCurrentIndex(-1);
-    ui->kursNameComboBox->blockSignals(false);
-
-    // Setting up the module combobox
-    QSqlQuery selectmodulequery = db->executeQuery("Module");
-    checkError(selectmodulequery.lastError(), tr("Error in 'selectmodulequery'"));
-    modulemodel->clear();
-    modulemodel->setQuery(selectmodulequery);
-    while (modulemodel->canFetchMore()) modulemodel->fetchMore();
-    checkError(modulemodel->lastError(), tr("Error setting query to 'modulemodel'"));
-
-    QSortFilterProxyModel *modulesfpm = new QSortFilterProxyModel(this);
-    modulesfpm->setSourceModel(modulemodel);
-    modulesfpm->setSortLocaleAware(true);
-    modulesfpm->sort(1, Qt::AscendingOrder);
-
-    ui->modulNameComboBox->blockSignals(true);
-    ui->modulNameComboBox->setModel(modulesfpm);
-    ui->modulNameComboBox->setModelColumn(1);
-    ui->modulNameComboBox->setCurrentIndex(-1);
-    ui->modulNameComboBox->blockSignals(false);
+void TransferAddDialog::courseCleared()
+{
+    if(cid.isEmpty()) return;
+
+    cid.clear();
+    ui->kursEctsLineEdit->clear();
+    ui->kursHerkunftLineEdit->clear();
+    ui->kursNameLineEdit->setToolTip(QString());
+    ui->kursAddButton->setEnabled(false);
 
     enableOkButton();
 }
 
 /*!
- * \brief Updates the GUI components for the course display
+ * \brief Updates the GUI components for the module display
  *
- * This function sets the ECTS, origin and name of the selected course into its according GUI elements.
+ * This function sets the ECTS and PO of the module \a record into its according GUI elements.
  * It also saves the underlying ID in a private dialog variable.
  *
  * Finally, the status of the buttons and the status message to display is adjusted.
  */
-void TransferAddDialog::on_kursNameComboBox_currentIndexChanged(int index)
+void TransferAddDialog::moduleSelected(const QSqlRecord &record)
 {
+    mid = record.value("ID").toString();
+    ui->modulEctsLineEdit->setText(record.value("ECTS").toString());
+    ui->modulPoLineEdit->setText(record.value("PO").toString());
+    ui->modulNameLineEdit->setToolTip(record.value("Modulname").toString());
+    ui->modulAddButton->setEnabled(true);
 
-    QSortFilterProxyModel *courseproxy = static_cast<QSortFilterProxyModel*>(ui->kursNameComboBox->model());
+    enableOkButton();
+}
 
-    QModelIndex qidx = courseproxy->mapToSource(ui->kursNameComboBox->model()->index(index,0));
+/*!
+ * \brief Resets the module display
+ *
+ * This function is called as soon as the module name is edited, as the previous module is no longer selected.
+ */
+void TransferAddDialog::moduleCleared()
+{
+    if(mid.isEmpty()) return;
 
-    cid = courseproxy->sourceModel()->data(qidx).toString();
-    ui->kursEctsLineEdit->setText(courseproxy->sourceModel()->data(courseproxy->sourceModel()->index(qidx.row(),3)).toString());
-    ui->kursHerkunftLineEdit->setText(courseproxy->sourceModel()->data(courseproxy->sourceModel()->index(qidx.row(),2)).toString());
-    ui->kursNameComboBox->setToolTip(ui->kursNameComboBox->currentText());
+    mid.clear();
+    ui->modulEctsLineEdit->clear();
+    ui->modulPoLineEdit->clear();
+    ui->modulNameLineEdit->setToolTip(QString());
+    ui->modulAddButton->setEnabled(false);
 
     enableOkButton();
 }
 
 /*!
- * \brief Updates the GUI components for the module display
+ * \brief Adds the selected course to the list of courses
  *
- * This function sets the ECTS, PO and name of the selected module into its according GUI elements.
- * It also saves the underlying ID in a private dialog variable.
+ * The name field is cleared afterwards, so the next course can be entered.
+ */
+void TransferAddDialog::on_kursAddButton_clicked()
+{
+    if(cid.isEmpty()) return;
+
+    addListEntry(ui->kursListWidget, cid, ui->kursNameLineEdit->text(), ui->kursEctsLineEdit->text().toInt());
+    ui->kursNameLineEdit->clear();
+    courseCleared();
+}
+
+/*!
+ * \brief Removes the selected entries from the list of courses
+ */
+void TransferAddDialog::on_kursRemoveButton_clicked()
+{
+    removeSelectedEntries(ui->kursListWidget);
+    enableOkButton();
+}
+
+/*!
+ * \brief Adds the courses whose names are in the clipboard to the list of courses
+ */
+void TransferAddDialog::on_kursPasteButton_clicked()
+{
+    pasteNames(ui->kursListWidget, "Kurse", "Kursname", "ID, Kursname, ECTS");
+}
+
+/*!
+ * \brief Enables the remove button of the course list if entries are selected
+ */
+void TransferAddDialog::on_kursListWidget_itemSelectionChanged()
+{
+    ui->kursRemoveButton->setEnabled(!ui->kursListWidget->selectedItems().isEmpty());
+}
+
+/*!
+ * \brief Adds the selected module to the list of modules
  *
- * Finally, the status of the buttons and the status message to display is adjusted.
+ * The name field is cleared afterwards, so the next module can be entered.
  */
-void TransferAddDialog::on_modulNameComboBox_currentIndexChanged(int index)
+void TransferAddDialog::on_modulAddButton_clicked()
 {
-    QSortFilterProxyModel *moduleproxy = static_cast<QSortFilterProxyModel*>(ui->modulNameComboBox->model());
+    if(mid.isEmpty()) return;
 
-    QModelIndex qidx = moduleproxy->mapToSource(ui->modulNameComboBox->model()->index(index,0));
+    addListEntry(ui->modulListWidget, mid, ui->modulNameLineEdit->text(), ui->modulEctsLineEdit->text().toInt());
+    ui->modulNameLineEdit->clear();
+    moduleCleared();
+}
 
-    mid = moduleproxy->sourceModel()->data(qidx).toString();
-    ui->modulEctsLineEdit->setText(moduleproxy->sourceModel()->data(moduleproxy->sourceModel()->index(qidx.row(),3)).toString());
-    ui->modulPoLineEdit->setText(moduleproxy->sourceModel()->data(moduleproxy->sourceModel()->index(qidx.row(),2)).toString());
-    ui->modulNameComboBox->setToolTip(ui->modulNameComboBox->currentText());
+/*!
+ * \brief Removes the selected entries from the list of modules
+ */
+void TransferAddDialog::on_modulRemoveButton_clicked()
+{
+    removeSelectedEntries(ui->modulListWidget);
+    enableOkButton();
+}
+
+/*!
+ * \brief Adds the modules whose names are in the clipboard to the list of modules
+ */
+void TransferAddDialog::on_modulPasteButton_clicked()
+{
+    pasteNames(ui->modulListWidget, "Module", "Modulname", "ID, Modulname, ECTS");
+}
+
+/*!
+ * \brief Enables the remove button of the module list if entries are selected
+ */
+void TransferAddDialog::on_modulListWidget_itemSelectionChanged()
+{
+    ui->modulRemoveButton->setEnabled(!ui->modulListWidget->selectedItems().isEmpty());
+}
+
+/*!
+ * \brief Adds the entries whose names are in the clipboard to a list
+ *
+ * The clipboard is expected to contain one name per line.
+ * All names are looked up at once in column \a column of table \a table, fetching the columns \a selectcols.
+ * Those need to start with the ID and the name and include the ECTS.
+ * The entries found are added to \a list, the names not found are reported to the user.
+ */
+void TransferAddDialog::pasteNames(QListWidget *list, const QString &table, const QString &column, const QString &selectcols)
+{
+    QStringList lines = QApplication::clipboard()->text().split('\n');
+    QStringList names;
+    for(int i = 0; i < lines.size(); i++) {
+        QString name = lines.at(i).trimmed();
+        if(!name.isEmpty()) {
+            names << name;
+        }
+    }
+    names.removeDuplicates();
+    if(names.isEmpty()) return;
+
+    QMap<QString, QList<QSqlRecord> > found = findByName(table, column, names, selectcols);
+    QStringList missing;
+    for(int i = 0; i < names.size(); i++) {
+        QList<QSqlRecord> records = found.value(names.at(i).toLower());
+        if(records.isEmpty()) {
+            missing << names.at(i);
+        }
+        for(int r = 0; r < records.size(); r++) {
+            const QSqlRecord &record = records.at(r);
+            addListEntry(list, record.value(0).toString(), record.value(1).toString(), record.value("ECTS").toInt());
+        }
+    }
+    if(!missing.isEmpty()) {
+        QMessageBox::warning(this, tr("Paste names"), tr("The following names could not be found:\n%1").arg(missing.join("\n")));
+    }
 
     enableOkButton();
 }
 
+/*!
+ * \brief Returns the entries whose names are \a names, keyed by their lower case names
+ *
+ * The names are looked up at once in column \a column of table \a table, fetching the columns \a selectcols.
+ * Those need to start with the ID and the name. Several entries may share a name.
+ */
+QMap<QString, QList<QSqlRecord> > TransferAddDialog::findByName(const QString &table, const QString &column, const QStringList &names, const QString &selectcols)
+{
+    QList<QSqlRecord> records = db->findEntriesByName(table, column, names, selectcols);
+    QMap<QString, QList<QSqlRecord> > found;
+    for(int i = 0; i < records.size(); i++) {
+        found[records.at(i).value(1).toString().toLower()] << records.at(i);
+    }
+    return found;
+}
+
+/*!
+ * \brief Removes the selected pairs from the list of pairs
+ */
+void TransferAddDialog::on_pairRemoveButton_clicked()
+{
+    removeSelectedEntries(ui->pairListWidget);
+    enableOkButton();
+}
+
+/*!
+ * \brief Adds the pairs of courses and modules in the clipboard to the list of pairs
+ *
+ * The clipboard is expected to contain one pair per line, the name of the course and the name of the module
+ * separated by a tab (as copied from a spreadsheet) or a semicolon.
+ * All names are looked up at once. Pairs with a name which is not found or which belongs to several entries
+ * are not added but reported to the user.
+ */
+void TransferAddDialog::on_pairPasteButton_clicked()
+{
+    QStringList lines = QApplication::clipboard()->text().split('\n');
+    QList<QPair<QString, QString> > names;
+    QStringList courseNames, moduleNames, invalid;
+    for(int i = 0; i < lines.size(); i++) {
+        QString line = lines.at(i).trimmed();
+        if(line.isEmpty()) continue;
+
+        QStringList parts = line.split(line.contains('\t') ? '\t' : ';');
+        if(parts.size() != 2 || parts.at(0).trimmed().isEmpty() || parts.at(1).trimmed().isEmpty()) {
+            invalid << line;
+            continue;
+        }
+        names << qMakePair(parts.at(0).trimmed(), parts.at(1).trimmed());
+        courseNames << parts.at(0).trimmed();
+        moduleNames << parts.at(1).trimmed();
+    }
+    if(names.isEmpty() && invalid.isEmpty()) return;
+
+    courseNames.removeDuplicates();
+    moduleNames.removeDuplicates();
+    QMap<QString, QList<QSqlRecord> > courses = findByName("Kurse", "Kursname", courseNames, "ID, Kursname, ECTS");
+    QMap<QString, QList<QSqlRecord> > modules = findByName("Module", "Modulname", moduleNames, "ID, Modulname, ECTS");
+
+    for(int i = 0; i < names.size(); i++) {
+        QList<QSqlRecord> course = courses.value(names.at(i).first.toLower());
+        QList<QSqlRecord> module = modules.value(names.at(i).second.toLower());
+        if(course.size() != 1 || module.size() != 1) {
+            invalid << QString("%1; %2").arg(names.at(i).first, names.at(i).second);
+            continue;
+        }
+        addPairEntry(course.first(), module.first());
+    }
+
+    if(!invalid.isEmpty()) {
+        QMessageBox::warning(this, tr("Paste pairs"), tr("The following lines are no pair of a course and a module found by their names "
+                                                         "or the names belong to several entries:\n%1").arg(invalid.join("\n")));
+    }
+
+    enableOkButton();
+}
+
+/*!
+ * \brief Enables the remove button of the pair list if entries are selected
+ */
+void TransferAddDialog::on_pairListWidget_itemSelectionChanged()
+{
+    ui->pairRemoveButton->setEnabled(!ui->pairListWidget->selectedItems().isEmpty());
+}
+
+/*!
+ * \brief Adds the pair of the course \a course and the module \a module to the list of pairs
+ *
+ * Both records need to start with the ID and the name and include the ECTS.
+ * Pairs already contained in the list are not added again.
+ */
+void TransferAddDialog::addPairEntry(const QSqlRecord &course, const QSqlRecord &module)
+{
+    QString id = course.value(0).toString() + "/" + module.value(0).toString();
+    QListWidget *list = ui->pairListWidget;
+    for(int i = 0; i < list->count(); i++) {
+        if(list->item(i)->data(Qt::UserRole).toString() == id) return;
+    }
+    QString text = QString("%1 (%2 ECTS)").arg(course.value(1).toString()).arg(course.value("ECTS").toInt())
+            + QString(" %1 ").arg(QChar(0x2192))
+            + QString("%1 (%2 ECTS)").arg(module.value(1).toString()).arg(module.value("ECTS").toInt());
+    QListWidgetItem *item = new QListWidgetItem(text, list);
+    item->setData(Qt::UserRole, id);
+    item->setData(Qt::UserRole + 1, course.value(0).toString());
+    item->setData(Qt::UserRole + 2, module.value(0).toString());
+}
+
+/*!
+ * \brief Adds the entry of ID \a id, name \a name and \a ects ECTS to \a list
+ *
+ * Entries already contained in the list are not added again.
+ */
+void TransferAddDialog::addListEntry(QListWidget *list, const QString &id, const QString &name, int ects)
+{
+    for(int i = 0; i < list->count(); i++) {
+        if(list->item(i)->data(Qt::UserRole).toString() == id) return;
+    }
+    QListWidgetItem *item = new QListWidgetItem(QString("%1 (%2 ECTS)").arg(name, QString::number(ects)), list);
+    item->setData(Qt::UserRole, id);
+    item->setData(Qt::UserRole + 1, ects);
+}
+
+/*!
+ * \brief Removes the selected entries from \a list
+ */
+void TransferAddDialog::removeSelectedEntries(QListWidget *list)
+{
+    QList<QListWidgetItem*> items = list->selectedItems();
+    for(int i = 0; i < items.size(); i++) {
+        delete items.at(i);
+    }
+}
+
+/*!
+ * \brief Returns the IDs of the entries in \a list
+ *
+ * If the list is empty, the ID \a current of the entry selected in the name field is returned instead.
+ */
+QStringList TransferAddDialog::selectedIds(QListWidget *list, const QString &current)
+{
+    QStringList ids;
+    for(int i = 0; i < list->count(); i++) {
+        ids << list->item(i)->data(Qt::UserRole).toString();
+    }
+    if(ids.isEmpty() && !current.isEmpty()) {
+        ids << current;
+    }
+    return ids;
+}
+
 /*!
  * \brief Updates the Buttons and the status message
  *
+ * The transfers to be added are the listed pairs and all pairs of the listed (or otherwise the selected) courses and modules.
+ * All of them are checked against the database at once.
+ *
  * The save button is only enabled if
  * \list
- *   \li both a course and a module are selected and
- *   \li the resulting transfer does not exist in the database.
+ *   \li at least one pair of a course and a module is given and
+ *   \li at least one of the resulting transfers does not exist in the database.
  * \endlist
  *
  * If the above case is not satisfied the status message is given as an error.
- * If the ECTS of course and module do not match the status message is set to a warning.
+ * If the ECTS of any module would differ from the sum of the ECTS of its courses, the status message is set to a warning,
+ * which lists these modules in its tool tip.
  */
 void TransferAddDialog::enableOkButton()
 {
-    if(mid.isEmpty() || mid.isEmpty()) {
+    QStringList cids = selectedIds(ui->kursListWidget, cid);
+    QStringList mids = selectedIds(ui->modulListWidget, mid);
+    transfers.clear();
+    ui->statusLabel->setToolTip(QString());
+
+    QList<QPair<QString, QString> > pairs;
+    QSet<QPair<QString, QString> > given;
+    for(int i = 0; i < ui->pairListWidget->count(); i++) {
+        QListWidgetItem *item = ui->pairListWidget->item(i);
+        QPair<QString, QString> pair = qMakePair(item->data(Qt::UserRole + 1).toString(), item->data(Qt::UserRole + 2).toString());
+        if(!given.contains(pair)) {
+            given.insert(pair);
+            pairs << pair;
+        }
+    }
+    for(int i = 0; i < cids.size(); i++) {
+        for(int j = 0; j < mids.size(); j++) {
+            QPair<QString, QString> pair = qMakePair(cids.at(i), mids.at(j));
+            if(!given.contains(pair)) {
+                given.insert(pair);
+                pairs << pair;
+            }
+        }
+    }
+
+    if(pairs.isEmpty()) {
         ui->statusIconLabel->setPixmap(style()->standardIcon(QStyle::SP_MessageBoxCritical).pixmap(32));
         ui->statusLabel->setText(tr("Please select a course and module first!"));
         ui->okButton->setEnabled(false);
         return;
     }
-    QStringList cols, vals;
-    cols << "KID" << "MID";
-    vals << cid << mid;
 
-    if(db->countEntries("Anerkennungen",cols,vals) > 0) {
+    QSet<QPair<QString, QString> > existing = db->findTransfers(pairs);
+    QList<QPair<QString, QString> > newPairs;
+    for(int i = 0; i < pairs.size(); i++) {
+        if(!existing.contains(pairs.at(i))) {
+            newPairs << pairs.at(i);
+            transfers << (QStringList() << pairs.at(i).first << pairs.at(i).second);
+        }
+    }
+    int total = pairs.size();
+
+    if(transfers.isEmpty()) {
         ui->statusIconLabel->setPixmap(style()->standardIcon(QStyle::SP_MessageBoxCritical).pixmap(32));
-        ui->statusLabel->setText(tr("This transfer already exists!"));
+        ui->statusLabel->setText((total == 1) ? tr("This transfer already exists!") : tr("All these transfers already exist!"));
         ui->okButton->setEnabled(false);
         return;
     }
-    if(ui->kursEctsLineEdit->text().toInt() != ui->modulEctsLineEdit->text().toInt()) {
-        ui->statusIconLabel->setPixmap(style()->standardIcon(QStyle::SP_MessageBoxWarning).pixmap(32));
-        ui->statusLabel->setText(tr("This transfer does not exist yet. Beware the ECTS-credits differ!"));
+
+    QList<QSqlRecord> deviations = db->findEctsDeviations(newPairs);
+    bool ectsDiffer = !deviations.isEmpty();
+    if(ectsDiffer) {
+        QStringList modules;
+        for(int i = 0; i < deviations.size(); i++) {
+            modules << tr("%1: %2 ECTS, courses %3 ECTS").arg(deviations.at(i).value("Modulname").toString())
+                       .arg(deviations.at(i).value("ECTS").toInt()).arg(deviations.at(i).value("Summe").toInt());
+        }
+        ui->statusLabel->setToolTip(modules.join("\n"));
+    }
+    if(total == 1) {
+        ui->statusLabel->setText(ectsDiffer ? tr("This transfer does not exist yet. Beware the ECTS-credits differ!") : tr("This transfer does not exist yet."));
+    } else if(ectsDiffer) {
+        ui->statusLabel->setText(tr("%1 of %2 transfers do not exist yet. Beware the ECTS-credits of %3 module(s) differ!")
+                                 .arg(transfers.size()).arg(total).arg(deviations.size()));
     } else {
-        ui->statusIconLabel->setPixmap(style()->standardIcon(QStyle::SP_MessageBoxInformation).pixmap(32));
-        ui->statusLabel->setText(tr("This transfer does not exist yet."));
+        ui->statusLabel->setText(tr("%1 of %2 transfers do not exist yet.").arg(transfers.size()).arg(total));
     }
+    ui->statusIconLabel->setPixmap(style()->standardIcon(ectsDiffer ? QStyle::SP_MessageBoxWarning : QStyle::SP_MessageBoxInformation).pixmap(32));
     ui->okButton->setEnabled(true);
 }
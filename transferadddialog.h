@@ -25,7 +25,12 @@
 #include <QDialog>
 #include <QtSql>
 #include <QDebug>
+#include <QListWidget>
+#include <QClipboard>
+#include <QApplication>
+#include <QMessageBox>
 #include "database.h"
+#include "entrylookup.h"
 
 
 namespace Ui {
@@ -39,25 +44,46 @@ class TransferAddDialog : public QDialog
 public:
     explicit TransferAddDialog(Database *mydb, QWidget *parent = 0);
     ~TransferAddDialog();
-    inline QString getMid() const {return mid;}
-    inline QString getCid() const {return cid;}
+    inline QVector<QStringList> getTransfers() const {return transfers;}
 
 private slots:
-    void on_kursNameComboBox_currentIndexChanged(int index);
+    void courseSelected(const QSqlRecord &record);
+    void courseCleared();
 
-    void on_modulNameComboBox_currentIndexChanged(int index);
+    void moduleSelected(const QSqlRecord &record);
+    void moduleCleared();
+
+    void on_kursAddButton_clicked();
+    void on_kursRemoveButton_clicked();
+    void on_kursPasteButton_clicked();
+    void on_kursListWidget_itemSelectionChanged();
+
+    void on_modulAddButton_clicked();
+    void on_modulRemoveButton_clicked();
+    void on_modulPasteButton_clicked();
+    void on_modulListWidget_itemSelectionChanged();
+
+    void on_pairRemoveButton_clicked();
+    void on_pairPasteButton_clicked();
+    void on_pairListWidget_itemSelectionChanged();
 
 private:
     Ui::TransferAddDialog *ui;
     Database *db;
-    QSqlQueryModel *coursemodel;
-    QSqlQueryModel *modulemodel;
+    EntryLookup *courseLookup;
+    EntryLookup *moduleLookup;
 
-    static void checkError(QSqlError error, const QString &text);
-    void initModels();
+    void initLookups();
     void enableOkButton();
+    void pasteNames(QListWidget *list, const QString &table, const QString &column, const QString &selectcols);
+    static void addListEntry(QListWidget *list, const QString &id, const QString &name, int ects);
+    void addPairEntry(const QSqlRecord &course, const QSqlRecord &module);
+    static void removeSelectedEntries(QListWidget *list);
+    static QStringList selectedIds(QListWidget *list, const QString &current);
+    QMap<QString, QList<QSqlRecord> > findByName(const QString &table, const QString &column, const QStringList &names, const QString &selectcols);
     QString mid;
     QString cid;
+    QVector<QStringList> transfers;
 
 };
 
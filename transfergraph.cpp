@@ -0,0 +1,318 @@
+/*
+ * transfergraph.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "transfergraph.h"
+
+/*!
+ * \class TransferGraph
+ *
+ * \brief In-memory index of the transfers between courses and modules
+ *
+ * The transfers form a bipartite graph between the courses and the modules.
+ * It is kept in both directions in compressed sparse row form: for each course the modules it is transferred to
+ * and for each module the courses transferred to it lie next to each other in a single array.
+ * Together with the names and ECTS of all courses and modules, this answers which entries are linked
+ * to a course or module without querying the database.
+ *
+ * The graph is loaded at once by \l load(). Single transfers are added and removed afterwards,
+ * the changed rows are kept apart until they make up a considerable share of all rows and the arrays are built anew.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs an empty TransferGraph
+ */
+TransferGraph::TransferGraph()
+{}
+
+/*!
+ * \brief Loads all transfers, courses and modules from the database connection \a db
+ *
+ * Returns \c true on success, otherwise \c false and the graph is empty.
+ */
+bool TransferGraph::load(QSqlDatabase db)
+{
+    clear();
+    if(!loadEntries(db, "SELECT ID, Kursname, ECTS FROM Kurse", courses)
+            || !loadEntries(db, "SELECT ID, Modulname, ECTS FROM Module", modules)) {
+        clear();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if(!query.exec("SELECT ID, KID, MID FROM Anerkennungen")) {
+        qCritical() << QObject::tr("Database error in '%1': %2").arg("TransferGraph").arg(query.lastError().text());
+        clear();
+        return false;
+    }
+    while(query.next()) {
+        transfers.insert(query.value(0).toInt(), qMakePair(query.value(1).toInt(), query.value(2).toInt()));
+    }
+    rebuild();
+    return true;
+}
+
+/*!
+ * \brief Removes all transfers, courses and modules
+ */
+void TransferGraph::clear()
+{
+    byCourse = Adjacency();
+    byModule = Adjacency();
+    transfers.clear();
+    courses.clear();
+    modules.clear();
+}
+
+/*!
+ * \brief Adds the transfer \a id of the course \a course to the module \a module
+ */
+void TransferGraph::addTransfer(int id, int course, int module)
+{
+    if(transfers.contains(id)) return;
+
+    transfers.insert(id, qMakePair(course, module));
+    insertEdge(byCourse, course, module);
+    insertEdge(byModule, module, course);
+    if(byCourse.changed.size() + byModule.changed.size() > transfers.size() / graph_rebuild_share + 64) {
+        rebuild();
+    }
+}
+
+/*!
+ * \brief Removes the transfer \a id
+ */
+void TransferGraph::removeTransfer(int id)
+{
+    if(!transfers.contains(id)) return;
+
+    QPair<int, int> edge = transfers.take(id);
+    removeEdge(byCourse, edge.first, edge.second);
+    removeEdge(byModule, edge.second, edge.first);
+    if(byCourse.changed.size() + byModule.changed.size() > transfers.size() / graph_rebuild_share + 64) {
+        rebuild();
+    }
+}
+
+/*!
+ * \brief Returns the IDs of the modules the course \a course is transferred to
+ *
+ * A module is contained once for each transfer.
+ */
+QVector<int> TransferGraph::modulesOf(int course) const
+{
+    return neighbours(byCourse, course);
+}
+
+/*!
+ * \brief Returns the IDs of the courses transferred to the module \a module
+ *
+ * A course is contained once for each transfer.
+ */
+QVector<int> TransferGraph::coursesOf(int module) const
+{
+    return neighbours(byModule, module);
+}
+
+/*!
+ * \brief Returns the number of transfers of the course \a course
+ */
+int TransferGraph::moduleCount(int course) const
+{
+    return degree(byCourse, course);
+}
+
+/*!
+ * \brief Returns the number of transfers to the module \a module
+ */
+int TransferGraph::courseCount(int module) const
+{
+    return degree(byModule, module);
+}
+
+/*!
+ * \brief Stores the course and the module of the transfer \a id in \a course and \a module
+ *
+ * Returns \c false if there is no such transfer.
+ */
+bool TransferGraph::transfer(int id, int &course, int &module) const
+{
+    QHash<int, QPair<int, int> >::const_iterator it = transfers.constFind(id);
+    if(it == transfers.constEnd()) {
+        return false;
+    }
+    course = it->first;
+    module = it->second;
+    return true;
+}
+
+/*!
+ * \brief Returns the name and ECTS of the course \a id
+ */
+TransferGraph::Entry TransferGraph::course(int id) const
+{
+    return courses.value(id);
+}
+
+/*!
+ * \brief Returns the name and ECTS of the module \a id
+ */
+TransferGraph::Entry TransferGraph::module(int id) const
+{
+    return modules.value(id);
+}
+
+/*!
+ * \brief Builds the compressed rows of both directions from all transfers
+ */
+void TransferGraph::rebuild()
+{
+    QVector<QPair<int, int> > edges;
+    edges.reserve(transfers.size());
+    QHash<int, QPair<int, int> >::const_iterator it = transfers.constBegin();
+    while(it != transfers.constEnd()) {
+        edges << it.value();
+        ++it;
+    }
+    build(byCourse, edges);
+
+    for(int i = 0; i < edges.size(); i++) {
+        edges[i] = qMakePair(edges.at(i).second, edges.at(i).first);
+    }
+    build(byModule, edges);
+}
+
+/*!
+ * \brief Builds \a adjacency from \a edges, each given by its source and target
+ *
+ * The rows are filled by counting the edges of each source first and placing them afterwards,
+ * so no list per source is needed.
+ */
+void TransferGraph::build(Adjacency &adjacency, const QVector<QPair<int, int> > &edges)
+{
+    adjacency = Adjacency();
+    QVector<int> rowOf(edges.size());
+    QVector<int> counts;
+    for(int i = 0; i < edges.size(); i++) {
+        int from = edges.at(i).first;
+        QHash<int, int>::const_iterator it = adjacency.rows.constFind(from);
+        if(it == adjacency.rows.constEnd()) {
+            it = adjacency.rows.insert(from, counts.size());
+            counts << 0;
+        }
+        rowOf[i] = it.value();
+        counts[it.value()]++;
+    }
+
+    adjacency.offsets.resize(counts.size() + 1);
+    adjacency.offsets[0] = 0;
+    for(int r = 0; r < counts.size(); r++) {
+        adjacency.offsets[r + 1] = adjacency.offsets.at(r) + counts.at(r);
+    }
+    adjacency.targets.resize(edges.size());
+    QVector<int> next = adjacency.offsets;
+    for(int i = 0; i < edges.size(); i++) {
+        adjacency.targets[next[rowOf.at(i)]++] = edges.at(i).second;
+    }
+}
+
+/*!
+ * \brief Returns the targets of \a from in \a adjacency
+ */
+QVector<int> TransferGraph::neighbours(const Adjacency &adjacency, int from)
+{
+    QHash<int, QVector<int> >::const_iterator changed = adjacency.changed.constFind(from);
+    if(changed != adjacency.changed.constEnd()) {
+        return changed.value();
+    }
+    QHash<int, int>::const_iterator it = adjacency.rows.constFind(from);
+    if(it == adjacency.rows.constEnd()) {
+        return QVector<int>();
+    }
+    int first = adjacency.offsets.at(it.value());
+    return adjacency.targets.mid(first, adjacency.offsets.at(it.value() + 1) - first);
+}
+
+/*!
+ * \brief Returns the number of targets of \a from in \a adjacency
+ */
+int TransferGraph::degree(const Adjacency &adjacency, int from)
+{
+    QHash<int, QVector<int> >::const_iterator changed = adjacency.changed.constFind(from);
+    if(changed != adjacency.changed.constEnd()) {
+        return changed->size();
+    }
+    QHash<int, int>::const_iterator it = adjacency.rows.constFind(from);
+    if(it == adjacency.rows.constEnd()) {
+        return 0;
+    }
+    return adjacency.offsets.at(it.value() + 1) - adjacency.offsets.at(it.value());
+}
+
+/*!
+ * \brief Adds the target \a to to the row of \a from in \a adjacency
+ */
+void TransferGraph::insertEdge(Adjacency &adjacency, int from, int to)
+{
+    if(!adjacency.changed.contains(from)) {
+        adjacency.changed.insert(from, neighbours(adjacency, from));
+    }
+    adjacency.changed[from].append(to);
+}
+
+/*!
+ * \brief Removes one occurrence of the target \a to from the row of \a from in \a adjacency
+ */
+void TransferGraph::removeEdge(Adjacency &adjacency, int from, int to)
+{
+    if(!adjacency.changed.contains(from)) {
+        adjacency.changed.insert(from, neighbours(adjacency, from));
+    }
+    QVector<int> &targets = adjacency.changed[from];
+    int index = targets.indexOf(to);
+    if(index > -1) {
+        targets.remove(index);
+    }
+}
+
+/*!
+ * \brief Loads the IDs, names and ECTS returned by \a sql on \a db into \a entries
+ *
+ * Returns \c true on success, otherwise \c false.
+ */
+bool TransferGraph::loadEntries(QSqlDatabase db, const QString &sql, QHash<int, Entry> &entries)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if(!query.exec(sql)) {
+        qCritical() << QObject::tr("Database error in '%1': %2").arg("TransferGraph").arg(query.lastError().text());
+        return false;
+    }
+    while(query.next()) {
+        Entry entry;
+        entry.name = query.value(1).toString();
+        entry.ects = query.value(2).toString();
+        entries.insert(query.value(0).toInt(), entry);
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+/*
+ * transfergraph.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANSFERGRAPH_H
+#define TRANSFERGRAPH_H
+
+// Share of changed rows (1/n of all rows) after which the compressed rows are built anew
+#define graph_rebuild_share 8
+
+#include <QtSql>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QString>
+
+class TransferGraph
+{
+public:
+    // Name and ECTS of a course or module
+    struct Entry {
+        QString name;
+        QString ects;
+    };
+
+    TransferGraph();
+
+    bool load(QSqlDatabase db);
+    void clear();
+
+    void addTransfer(int id, int course, int module);
+    void removeTransfer(int id);
+
+    QVector<int> modulesOf(int course) const;
+    QVector<int> coursesOf(int module) const;
+    int moduleCount(int course) const;
+    int courseCount(int module) const;
+    bool transfer(int id, int &course, int &module) const;
+    Entry course(int id) const;
+    Entry module(int id) const;
+
+private:
+    // One direction of the graph in compressed sparse row form
+    struct Adjacency {
+        // row of each ID, the targets of row r are targets[offsets[r]] to targets[offsets[r + 1] - 1]
+        QHash<int, int> rows;
+        QVector<int> offsets;
+        QVector<int> targets;
+        // rows changed since the last build, which replace the compressed ones
+        QHash<int, QVector<int> > changed;
+    };
+
+    Adjacency byCourse;
+    Adjacency byModule;
+    QHash<int, QPair<int, int> > transfers;
+    QHash<int, Entry> courses;
+    QHash<int, Entry> modules;
+
+    void rebuild();
+    static void build(Adjacency &adjacency, const QVector<QPair<int, int> > &edges);
+    static QVector<int> neighbours(const Adjacency &adjacency, int from);
+    static int degree(const Adjacency &adjacency, int from);
+    static void insertEdge(Adjacency &adjacency, int from, int to);
+    static void removeEdge(Adjacency &adjacency, int from, int to);
+    static bool loadEntries(QSqlDatabase db, const QString &sql, QHash<int, Entry> &entries);
+};
+
+#endif // TRANSFERGRAPH_H
@@ -0,0 +1,145 @@
+/*
+ * transferprefetcher.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "transferprefetcher.h"
+
+/*!
+ * \class TransferPrefetcher
+ *
+ * \brief Fetches the transfers of courses or modules in the background
+ *
+ * The prefetcher is meant to live in a worker thread. It uses a database connection of its own,
+ * which is opened on the first request within that thread.
+ *
+ * For each requested ID the entries of a read-only view (\tt anerkmodule or \tt anerkkurse)
+ * are fetched and handed back by the signal prefetched().
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs the TransferPrefetcher
+ *
+ * \a parent is passed to the QObject constructor.
+ */
+TransferPrefetcher::TransferPrefetcher(QObject *parent) :
+    QObject(parent),
+    connectionName(QString("prefetch-%1").arg(reinterpret_cast<quintptr>(this)))
+{
+}
+
+/*!
+ * \brief Destroys the TransferPrefetcher
+ *
+ * It also removes its database connection, so it needs to be destroyed in the worker thread.
+ */
+TransferPrefetcher::~TransferPrefetcher()
+{
+    closeDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+/*!
+ * \brief Registers the types used in the signal prefetched() for queued connections
+ */
+void TransferPrefetcher::registerMetaTypes()
+{
+    qRegisterMetaType<QSqlRecord>("QSqlRecord");
+    qRegisterMetaType<QVector<QSqlRecord> >("QVector<QSqlRecord>");
+}
+
+/*!
+ * \brief Opens the connection to the database at \a databasePath
+ *
+ * The path may also be a \c file: URI, e.g. for a read-only snapshot.
+ * An open connection to another file is closed first.
+ * Returns \c true if the connection is open.
+ */
+bool TransferPrefetcher::openDatabase(const QString &databasePath)
+{
+    QSqlDatabase db = QSqlDatabase::contains(connectionName) ? QSqlDatabase::database(connectionName, false)
+                                                             : QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    if(db.isOpen() && db.databaseName() == databasePath) {
+        return true;
+    }
+    db.close();
+    db.setDatabaseName(databasePath);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_OPEN_URI");
+    if(!db.open()) {
+        qCritical() << QObject::tr("Error opening prefetch connection:") << db.lastError();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Closes the database connection
+ *
+ * This needs to be done before the database file is replaced.
+ */
+void TransferPrefetcher::closeDatabase()
+{
+    if(QSqlDatabase::contains(connectionName)) {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        db.close();
+    }
+}
+
+/*!
+ * \brief Fetches the entries of \a view for each ID in \a ids
+ *
+ * The database at \a databasePath is used. All IDs are fetched in a single query.
+ * For each ID the signal prefetched() is emitted with its entries (possibly none) and the data version \a version of the request,
+ * which allows the receiver to discard outdated results.
+ * If the database cannot be opened or queried, the signal prefetchFailed() is emitted with all \a ids instead,
+ * so that they can be requested again.
+ */
+void TransferPrefetcher::prefetch(const QString &databasePath, const QString &view, const QStringList &ids, int version)
+{
+    if(ids.isEmpty()) return;
+    if(!openDatabase(databasePath)) {
+        emit prefetchFailed(view, ids, version);
+        return;
+    }
+
+    QSqlQuery query(QSqlDatabase::database(connectionName, false));
+    query.prepare(QString("SELECT * FROM %1 WHERE ID IN (%2)").arg(view).arg(QString("?,").repeated(ids.size()-1).append("?")));
+    for(int i = 0; i < ids.size(); i++) {
+        query.bindValue(i, ids.at(i));
+    }
+    if(!query.exec()) {
+        qCritical() << QObject::tr("Error in prefetch:") << query.lastError();
+        emit prefetchFailed(view, ids, version);
+        return;
+    }
+
+    QHash<QString, QVector<QSqlRecord> > records;
+    while(query.next()) {
+        QSqlRecord record = query.record();
+        records[record.value("ID").toString()] << record;
+    }
+    QSqlRecord header = query.record();
+    query.finish();
+
+    for(int i = 0; i < ids.size(); i++) {
+        emit prefetched(view, ids.at(i), version, header, records.value(ids.at(i)));
+    }
+}
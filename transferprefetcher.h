@@ -0,0 +1,57 @@
+/*
+ * transferprefetcher.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANSFERPREFETCHER_H
+#define TRANSFERPREFETCHER_H
+
+#include <QObject>
+#include <QtSql>
+#include <QtDebug>
+#include <QVector>
+#include <QMetaType>
+
+Q_DECLARE_METATYPE(QSqlRecord)
+
+class TransferPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TransferPrefetcher(QObject *parent = nullptr);
+    ~TransferPrefetcher() Q_DECL_OVERRIDE;
+
+    static void registerMetaTypes();
+
+public slots:
+    void prefetch(const QString &databasePath, const QString &view, const QStringList &ids, int version);
+    void closeDatabase();
+
+signals:
+    void prefetched(const QString &view, const QString &id, int version, const QSqlRecord &header, const QVector<QSqlRecord> &records);
+    void prefetchFailed(const QString &view, const QStringList &ids, int version);
+
+private:
+    QString connectionName;
+
+    bool openDatabase(const QString &databasePath);
+};
+
+#endif // TRANSFERPREFETCHER_H
@@ -0,0 +1,196 @@
+/*
+ * trigramindex.cpp
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "trigramindex.h"
+#include <algorithm>
+
+/*!
+ * \class TrigramIndex
+ *
+ * \brief Index of the names of courses or modules to find similar names
+ *
+ * Each name is split into trigrams, the sequences of three characters of its lower case words,
+ * which are padded with spaces. For each trigram the index lists the entries containing it.
+ * The similarity of two names is the share of their common trigrams (Dice coefficient),
+ * so that "Statistik I", "Statistik 1" and "Statistik I (WS)" are found to be similar.
+ *
+ * A search only visits the entries sharing at least one trigram with the searched name,
+ * which keeps it fast even for large numbers of entries.
+ *
+ * \since 3.3
+ */
+
+/*!
+ * \brief Constructs an empty TrigramIndex
+ */
+TrigramIndex::TrigramIndex()
+{}
+
+/*!
+ * \brief Loads the entries returned by \a sql on the database connection \a db
+ *
+ * The query needs to return the ID, the name, the origin or PO and the ECTS of each entry in this order.
+ * Returns \c true on success, otherwise \c false and the index is empty.
+ */
+bool TrigramIndex::load(QSqlDatabase db, const QString &sql)
+{
+    clear();
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if(!query.exec(sql)) {
+        qCritical() << QObject::tr("Database error in '%1': %2").arg("TrigramIndex").arg(query.lastError().text());
+        return false;
+    }
+    while(query.next()) {
+        insert(query.value(0).toInt(), query.value(1).toString(), query.value(2).toString(), query.value(3).toInt());
+    }
+    return true;
+}
+
+/*!
+ * \brief Removes all entries
+ */
+void TrigramIndex::clear()
+{
+    entries.clear();
+    postings.clear();
+    counts.clear();
+}
+
+/*!
+ * \brief Adds the entry \a id of name \a name, origin or PO \a other and \a ects ECTS
+ */
+void TrigramIndex::insert(int id, const QString &name, const QString &other, int ects)
+{
+    QVector<quint64> grams = trigrams(name);
+    Entry entry;
+    entry.id = id;
+    entry.name = name;
+    entry.other = other;
+    entry.ects = ects;
+    entry.trigramCount = grams.size();
+
+    int index = entries.size();
+    entries.append(entry);
+    counts.append(0);
+    for(int i = 0; i < grams.size(); i++) {
+        postings[grams.at(i)].append(index);
+    }
+}
+
+/*!
+ * \brief Returns at most \a limit entries whose names are similar to \a name, the most similar first
+ *
+ * Only entries sharing at least \c similarity_threshold of their trigrams are returned.
+ * Entries with the same origin or PO \a other or the same ECTS \a ects are ranked higher.
+ * The entry \a excludeId, e.g. the one being edited, is left out.
+ */
+QList<TrigramIndex::Match> TrigramIndex::similar(const QString &name, const QString &other, int ects, int limit, int excludeId) const
+{
+    QList<Match> matches;
+    QVector<quint64> grams = trigrams(name);
+    if(grams.isEmpty()) {
+        return matches;
+    }
+
+    // count the common trigrams of all entries sharing any
+    QVector<int> touched;
+    for(int i = 0; i < grams.size(); i++) {
+        QHash<quint64, QVector<int> >::const_iterator it = postings.constFind(grams.at(i));
+        if(it == postings.constEnd()) continue;
+        const QVector<int> &list = it.value();
+        for(int j = 0; j < list.size(); j++) {
+            if(counts[list.at(j)]++ == 0) {
+                touched.append(list.at(j));
+            }
+        }
+    }
+
+    for(int i = 0; i < touched.size(); i++) {
+        int index = touched.at(i);
+        const Entry &entry = entries.at(index);
+        double similarity = 2.0 * counts.at(index) / (grams.size() + entry.trigramCount);
+        counts[index] = 0;
+        if(similarity < similarity_threshold || entry.id == excludeId) continue;
+
+        Match match;
+        match.id = entry.id;
+        match.name = entry.name;
+        match.other = entry.other;
+        match.ects = entry.ects;
+        match.similarity = similarity;
+        match.score = similarity;
+        if(!other.isEmpty() && entry.other.compare(other, Qt::CaseInsensitive) == 0) {
+            match.score += similarity_other_bonus;
+        }
+        if(ects > 0 && entry.ects == ects) {
+            match.score += similarity_ects_bonus;
+        }
+        matches.append(match);
+    }
+
+    std::sort(matches.begin(), matches.end(), higherScore);
+    return matches.mid(0, limit);
+}
+
+/*!
+ * \brief Returns the distinct trigrams of \a text, each packed into an integer
+ *
+ * The text is converted to lower case and split into words at anything but letters and digits.
+ * Each word is padded by two spaces in front and one at the end, so short words and their beginnings count as well.
+ */
+QVector<quint64> TrigramIndex::trigrams(const QString &text)
+{
+    QVector<quint64> grams;
+    QString lower = text.toLower();
+    QString word;
+    for(int i = 0; i <= lower.size(); i++) {
+        QChar c = (i < lower.size()) ? lower.at(i) : QChar(' ');
+        if(c.isLetterOrNumber()) {
+            word.append(c);
+            continue;
+        }
+        if(word.isEmpty()) continue;
+
+        QString padded = "  " + word + " ";
+        for(int j = 0; j + 2 < padded.size(); j++) {
+            grams.append((quint64(padded.at(j).unicode()) << 32) | (quint64(padded.at(j + 1).unicode()) << 16)
+                         | quint64(padded.at(j + 2).unicode()));
+        }
+        word.clear();
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+/*!
+ * \brief Returns whether the match \a a is ranked before \a b
+ *
+ * Matches of the same score are ordered by their names.
+ */
+bool TrigramIndex::higherScore(const Match &a, const Match &b)
+{
+    if(a.score != b.score) {
+        return a.score > b.score;
+    }
+    return a.name < b.name;
+}
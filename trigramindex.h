@@ -0,0 +1,77 @@
+/*
+ * trigramindex.h
+ *
+ * This file is part of AnerkennungsDB.
+ *
+ * Copyright (C) 2026 Paul Fink <paul.fink@mailbox.org>
+ *
+ * AnerkennungsDB is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * AnerkennungsDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+// Least share of common trigrams (Dice coefficient) of a similar name
+#define similarity_threshold 0.4
+// Added to the score of an entry with the same origin/PO or the same ECTS
+#define similarity_other_bonus 0.15
+#define similarity_ects_bonus 0.1
+
+#include <QtSql>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QString>
+
+class TrigramIndex
+{
+public:
+    // Entry with a name similar to the searched one
+    struct Match {
+        int id;
+        QString name;
+        QString other;
+        int ects;
+        double similarity;
+        double score;
+    };
+
+    TrigramIndex();
+
+    bool load(QSqlDatabase db, const QString &sql);
+    void clear();
+    void insert(int id, const QString &name, const QString &other, int ects);
+
+    QList<Match> similar(const QString &name, const QString &other, int ects, int limit, int excludeId = -1) const;
+
+private:
+    struct Entry {
+        int id;
+        QString name;
+        QString other;
+        int ects;
+        int trigramCount;
+    };
+
+    QVector<Entry> entries;
+    // Entries (indexes into entries) containing each trigram
+    QHash<quint64, QVector<int> > postings;
+    // Number of common trigrams per entry while searching, reset afterwards
+    mutable QVector<int> counts;
+
+    static QVector<quint64> trigrams(const QString &text);
+    static bool higherScore(const Match &a, const Match &b);
+};
+
+#endif // TRIGRAMINDEX_H